@@ -7,9 +7,11 @@
 #ifndef ARGS_H
 #define ARGS_H
 
-#include <netinet/in.h> // struct sockaddr_in
+#include <sys/socket.h> // struct sockaddr_storage
 #include <array>
 #include <string>
+#include <string_view>
+#include <vector>
 
 /**
  * @class Args
@@ -24,6 +26,21 @@ public:
      */
     Args(int argc, char** argv);
 
+    /**
+     * @brief Constructs default arguments (UDP, port 4567, no server) of a session embedded into another program,
+     * which sets the server by the setters below.
+     */
+    Args() = default;
+
+    /// @param is_tcp True to select TCP; false for UDP.
+    void setIsTcp(bool is_tcp);
+
+    /// @param server_hostname Server hostname or IP address (resolved when a session is created).
+    void setServerHostname(std::string server_hostname);
+
+    /// @param server_port Server port.
+    void setServerPort(uint16_t server_port);
+
     // 'getters'
 
     /// @return True if TCP is selected; false for UDP.
@@ -32,47 +49,99 @@ public:
     /// @return Maximum number of UDP retransmission attempts.
     uint8_t getUdpMaxRetransCount() const;
 
-    /// @return Pointer to internal sockaddr_in structure used for the server address.
-    struct sockaddr_in* getServerAddrStructAddress();
+    /// @return Server hostname or IP address given by -s.
+    const std::string& getServerHostname() const;
+
+    /// @return Server port.
+    uint16_t getServerPort() const;
+
+    /**
+     * @brief Stores the addresses the server hostname has been resolved to.
+     * @param server_addrs Resolved addresses (at least one).
+     */
+    void setServerAddrs(std::vector<struct sockaddr_storage> server_addrs);
+
+    /// @return Pointer to internal IPv4 or IPv6 address structure used for the server address.
+    struct sockaddr_storage* getServerAddrStructAddress();
+
+    /// @return All addresses the server's hostname has been resolved to (the first one is used by UDP).
+    const std::vector<struct sockaddr_storage>& getServerAddrs() const;
 
-    /// @return Size of the sockaddr_in structure.
-    int getSizeofServerAddrStruct() const;
+    /// @return Time in milliseconds allowed for establishing the TCP connection.
+    uint16_t getTcpConnectTimeout() const;
 
-    /// @return Timeout in milliseconds used to confirm UDP delivery.
+    /// @return Size of the server address (sockaddr_in or sockaddr_in6 according to its family).
+    socklen_t getSizeofServerAddrStruct() const;
+
+    /// @return Timeout in milliseconds used to confirm UDP delivery (initial timeout if it isn't set by -d).
     uint16_t getUdpConfirmTimeout() const;
 
+    /// @return Lower bound in milliseconds of the adaptive UDP confirmation timeout.
+    uint16_t getUdpMinConfirmTimeout() const;
+
+    /// @return Upper bound in milliseconds of the adaptive UDP confirmation timeout.
+    uint16_t getUdpMaxConfirmTimeout() const;
+
+    /// @return True if the UDP confirmation timeout is fixed by the -d flag instead of being adapted to the measured RTT.
+    bool getIsUdpConfirmTimeoutSet() const;
+
+    /// @return Maximum number of unconfirmed UDP messages (1 means stop-and-wait).
+    uint16_t getUdpWindowSize() const;
+
     /// @return True if the help flag (-h) was used.
     bool getIsHelpUsed() const;
 
+    /// @return Number of load sessions run by one process, 0 for the interactive client.
+    uint32_t getSessionCount() const;
+
+    /// @return Path to the script of the load sessions.
+    const std::string& getScriptPath() const;
+
+    /// @return Pause in milliseconds before every line of the script.
+    uint32_t getThinkTime() const;
+
+    /// @return Max number of chat messages sent by one load session per second (0 means no limit).
+    uint32_t getMsgRate() const;
+
     // end of 'getters'
 
     // bool getIsConstructorErr() const;
 
     /// @brief Prints usage information to stdout.
     static void printHelp();
+
+    /// Max value of -R (chat messages per second of a load session).
+    static constexpr uint32_t s_MAX_MSG_RATE{1000};
     
 private:
+    /**
+     * @brief Converts a flag value to an unsigned 32-bit number.
+     * @param value Value of the flag.
+     * @param error_msg Explanation of the exception thrown if the value doesn't fit.
+     * @return The number.
+     */
+    static uint32_t parseUint32(const char* value, std::string_view error_msg);
+
     uint16_t m_server_port{4567};                                        ///< Server port number.
     uint16_t m_udp_confirm_timeout{250};                                 ///< Timeout for UDP confirmation (ms).
     uint8_t m_udp_max_retrans_count{3};                                  ///< Max UDP retransmission attempts.
+    uint16_t m_udp_window_size{1};                                       ///< Max number of unconfirmed UDP messages.
+    uint16_t m_udp_min_confirm_timeout{10};                              ///< Lower bound of the adaptive timeout (ms).
+    uint16_t m_udp_max_confirm_timeout{5000};                            ///< Upper bound of the adaptive timeout (ms).
+    bool m_is_udp_confirm_timeout_set{false};                            ///< True if the timeout was fixed by -d.
+    uint16_t m_tcp_connect_timeout{10000};                               ///< Deadline of the TCP connection (ms).
     bool m_is_help_used{false};                                          ///< Indicates if help was requested.
-    const std::array<char, 6> m_arg_flags{'t', 's', 'p', 'd', 'r', 'h'}; ///< Valid argument flags.
+    uint32_t m_session_count{0};                                         ///< Number of load sessions (0 if not load testing).
+    std::string m_script_path{};                                         ///< Script of the load sessions.
+    uint32_t m_think_time{0};                                            ///< Pause before every line of the script (ms).
+    uint32_t m_msg_rate{0};                                              ///< Chat messages per second of a load session.
+    const std::array<char, 14> m_arg_flags{'t', 's', 'p', 'd', 'r', 'h', 'w', 'm', 'M', 'c', 'n', 'f', 'i', 'R'}; ///< Valid argument flags.
     bool m_is_tcp{};                                                     ///< Protocol flag: true for TCP, false for UDP.
-    struct sockaddr_in m_server_addr{};                                  ///< Parsed server address.
+    std::string m_server_hostname{};                                     ///< Server hostname or IP address.
+    struct sockaddr_storage m_server_addr{};                             ///< Resolved server address (IPv4 or IPv6).
+    std::vector<struct sockaddr_storage> m_server_addrs{};               ///< All resolved server addresses.
 
     // void checkNextArgument(int current_arg, int argc) const;
-
-    /**
-     * @brief Converts and validates a given server address (IP or hostname).
-     * @param server_addr Server address string (IP or hostname).
-     */
-    void processServerAddress(const char* server_addr);
-
-    /**
-     * @brief Converts a hostname to an IP address and stores it in m_server_addr.
-     * @param hostname Server hostname.
-     */
-    void hostnameToIpAddress(const char* hostname);
 };
 
 #endif // ARGS_H
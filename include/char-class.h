@@ -0,0 +1,85 @@
+/**
+ * @file char-class.h
+ * @author Andrii Klymenko
+ * @brief Lookup table of character classes used by the IPK25-CHAT grammar.
+ */
+
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class Char_class
+ * @brief 256-entry table classifying each byte into the character classes of the IPK25-CHAT grammar.
+ *
+ * Replaces the regex bracket expressions of the grammar ([!-~], [\x20-\x7E\n] and [a-zA-Z0-9_-]), so that
+ * a whole field can be validated with one table lookup per byte.
+ */
+class Char_class {
+public:
+    static constexpr uint8_t s_PRINTABLE{0x01};                   ///< [!-~] (printable characters without space).
+    static constexpr uint8_t s_PRINTABLE_SPACE_LF{0x02};          ///< [\x20-\x7E\n] (message content).
+    static constexpr uint8_t s_ALPHANUMERIC_UNDERLINE_DASH{0x04}; ///< [a-zA-Z0-9_-] (username, channel ID).
+
+    /**
+     * @brief Checks whether a character belongs to the given class.
+     * @param c Character to check.
+     * @param char_class One of the s_* class flags.
+     */
+    static constexpr bool is(char c, uint8_t char_class)
+    {
+        return (s_TABLE[static_cast<unsigned char> (c)] & char_class) != 0;
+    }
+
+    /**
+     * @brief Returns the length of the longest prefix of data consisting of characters of the given class.
+     * @param data Data to scan.
+     * @param char_class One of the s_* class flags.
+     */
+    static constexpr std::size_t span(std::string_view data, uint8_t char_class)
+    {
+        std::size_t length{0};
+
+        while(length < data.size() && is(data[length], char_class))
+        {
+            ++length;
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Checks whether data is non-empty and consists only of characters of the given class.
+     * @param data Data to check.
+     * @param char_class One of the s_* class flags.
+     */
+    static constexpr bool isAll(std::string_view data, uint8_t char_class)
+    {
+        return !data.empty() && span(data, char_class) == data.size();
+    }
+
+private:
+    /// Class flags of every possible byte value.
+    static constexpr std::array<uint8_t, 256> s_TABLE{[] {
+        std::array<uint8_t, 256> table{};
+
+        for(unsigned c{'!'}; c <= '~'; ++c)
+        {
+            table[c] |= s_PRINTABLE | s_PRINTABLE_SPACE_LF;
+
+            if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-')
+            {
+                table[c] |= s_ALPHANUMERIC_UNDERLINE_DASH;
+            }
+        }
+
+        table[' '] |= s_PRINTABLE_SPACE_LF;
+        table['\n'] |= s_PRINTABLE_SPACE_LF;
+        return table;
+    }()};
+};
+
+#endif // CHAR_CLASS_H
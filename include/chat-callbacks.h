@@ -0,0 +1,44 @@
+/**
+ * @file chat-callbacks.h
+ * @author Andrii Klymenko
+ * @brief Callbacks through which a client session reports what it receives.
+ */
+
+#ifndef CHAT_CALLBACKS_H
+#define CHAT_CALLBACKS_H
+
+#include <functional>
+#include <string_view>
+
+/**
+ * @brief Receivers of the output of a client session; any of them may be left empty.
+ *
+ * They are called by the thread running the session's Event_loop. The views are valid only during the call.
+ */
+struct Chat_callbacks {
+    /// A MSG message from another user of the channel.
+    std::function<void(std::string_view display_name, std::string_view content)> on_message{};
+
+    /// The REPLY to an AUTH or JOIN message.
+    std::function<void(bool is_positive, std::string_view content)> on_reply{};
+
+    /// An ERR message from the server (the session terminates).
+    std::function<void(std::string_view display_name, std::string_view content)> on_server_error{};
+
+    /// A local text for the user (the help).
+    std::function<void(std::string_view text)> on_output{};
+
+    /// A local error (invalid user input, a protocol or network failure), without the "ERROR: " prefix.
+    std::function<void(std::string_view err_msg)> on_error{};
+
+    /// The session has terminated; it is the last callback of the session.
+    std::function<void(bool is_success)> on_close{};
+
+    /**
+     * @brief Creates callbacks printing the output to stdout and the errors to stderr (the interactive client).
+     * @param is_chat_output_enabled False to print only the errors (load sessions count the rest).
+     */
+    static Chat_callbacks createConsole(bool is_chat_output_enabled);
+};
+
+#endif // CHAT_CALLBACKS_H
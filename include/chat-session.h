@@ -0,0 +1,60 @@
+/**
+ * @file chat-session.h
+ * @author Andrii Klymenko
+ * @brief Handle of a client session embedded into another program (bot, gateway).
+ */
+
+#ifndef CHAT_SESSION_H
+#define CHAT_SESSION_H
+
+#include "args.h"
+#include "chat-callbacks.h"
+#include "event-loop.h"
+#include "line-queue.h"
+#include <memory>
+#include <string_view>
+
+/**
+ * @class Chat_session
+ * @brief Session of the library interface: user input is pushed by send() instead of being read from stdin and the
+ * output is passed to Chat_callbacks instead of being printed.
+ *
+ * The session itself is owned by the Event_loop it has been added to and runs while the loop runs; the handle only
+ * shares its input, so it may outlive the session (lines sent after the termination are ignored). Any number of
+ * sessions may share one loop. A loop of the embedding program is constructed as Event_loop{false}, so that SIGINT
+ * stays with the program.
+ */
+class Chat_session {
+public:
+    /**
+     * @brief Creates a session and adds it to the loop; it starts by resolving the server hostname.
+     * Has to be called by the thread running the loop (or before the loop runs).
+     * @param event_loop Loop running the session.
+     * @param args Transport, server and protocol parameters of the session.
+     * @param callbacks Receivers of the output of the session.
+     * @return Handle of the session.
+     */
+    static Chat_session create(Event_loop& event_loop, const Args& args, Chat_callbacks callbacks);
+
+    /**
+     * @brief Sends a line of user input (a command such as /auth or /join, or a chat message). Thread-safe.
+     * @param line The line, without LF.
+     */
+    void send(std::string_view line);
+
+    /**
+     * @brief Ends the user input: the session says BYE once the lines sent before are processed. Thread-safe.
+     */
+    void close();
+
+private:
+    /**
+     * @brief Constructs a handle of the session reading the given input.
+     * @param input Input of the session.
+     */
+    explicit Chat_session(std::shared_ptr<Line_queue> input);
+
+    std::shared_ptr<Line_queue> m_input; ///< Input shared with the session.
+};
+
+#endif // CHAT_SESSION_H
@@ -8,229 +8,227 @@
 #define CLIENT_H
 
 #include "args.h"
-#include "protocol-msg-type.h"
-#include "fsm.h"
-#include <regex>
+#include "timer-wheel.h"
+#include "input-source.h"
+#include "outbound-msg.h"
+#include "host-resolver.h"
+#include "event-loop.h"
+#include "session-stats.h"
+#include "protocol-session.h"
+#include "chat-callbacks.h"
+#include "session-outcome.h"
+#include <memory>
+#include <optional>
+#include <vector>
 #include <sys/epoll.h>
 #include <sys/timerfd.h>
-#include <csignal>
-#include <functional>
+#include <chrono>
 
 /**
  * @class Client
- * @brief Abstract base class for implementing a chat client using FSM and epoll.
+ * @brief Abstract base class of the I/O of a chat client session; its events are dispatched by Event_loop.
+ *
+ * The protocol itself is implemented by a Protocol_session of the derived class. The client feeds it with the user
+ * input, the data from the socket and the expirations of the timer and performs the actions it returns; the client
+ * only resolves the server address, connects to the server and paces the user input. Everything the session receives
+ * or reports is passed to Chat_callbacks, so the client itself doesn't depend on stdin or stdout.
  */
 class Client {
 public:
 
     /**
-     * @brief Constructs a Client object with parsed arguments.
+     * @brief Constructs a Client object with parsed arguments and registers its file descriptors in the event loop.
      * @param args Command line arguments.
+     * @param event_loop Loop dispatching the events of the session.
+     * @param input_source User input of the session (shared with the program pushing the lines, if any).
+     * @param callbacks Receivers of the output of the session.
      */
-    Client(const Args& args);
+    Client(const Args& args, Event_loop& event_loop, std::shared_ptr<Input_source> input_source,
+           Chat_callbacks callbacks);
 
     /**
      * @brief Factory method for creating a Client instance.
      * @param args Command line arguments.
+     * @param event_loop Loop dispatching the events of the session.
+     * @param input_source User input of the session (shared with the program pushing the lines, if any).
+     * @param callbacks Receivers of the output of the session.
      * @return A unique pointer to a new Client instance.
      */
-    static std::unique_ptr<Client> create(const Args& args);
-    // virtual bool run() = 0;
+    static std::unique_ptr<Client> create(const Args& args, Event_loop& event_loop,
+                                          std::shared_ptr<Input_source> input_source, Chat_callbacks callbacks);
 
     /**
-     * @brief Runs the main client loop.
-     * @return True on success, false on failure.
+     * @brief Records an event of one of the session's file descriptors; it is processed by processReadyEvents().
+     * Events of TCP connection attempts are processed at once.
+     * @param file_descriptor File descriptor the event has been reported for.
+     * @param events Ready event flags reported by epoll_wait().
+     * @return Whether the session keeps running.
      */
-    bool run();
+    Session_outcome processEvent(int file_descriptor, uint32_t events);
 
     /**
-     * @brief Virtual destructor.
-     */
-    virtual ~Client();
-
-    /**
-     * @brief Sends a BYE message to the server. Must be implemented by derived class.
+     * @brief Processes the recorded events in a fixed order (socket, timer, user input) and the queued user input.
+     * @return Whether the session keeps running.
      */
-    virtual void sendByeMsgToServer() = 0;
-
-    /// Maximum number of seconds to wait for a REPLY message.
-    static constexpr uint8_t s_MAX_REPLY_WAIT_TIME{5};
-
-protected:
-    Args m_args; ///< Parsed arguments.
-    FSM_state m_current_state{FSM_state::S_START}; ///< Current state of the FSM.
-
-    std::string m_user_display_name{"unknown"}; ///< Display name of the user.
-
-    /// Supported user commands.
-    const std::array<std::string_view, 4> m_user_commands{"/auth", "/help", "/join", "/rename"};
-
-    bool m_is_waiting_for_reply{false}; ///< True if waiting for server REPLY message.
+    Session_outcome processReadyEvents();
 
-    // File descriptors
-    int m_client_socket{}; ///< Socket file descriptor.
-    int m_epoll_fd{};      ///< Epoll file descriptor.
-    int m_timer_fd{};      ///< Timer file descriptor.
-
-    // Epoll event structures
-    struct epoll_event m_socket_event{.events = EPOLLIN, .data = {} };
-    struct epoll_event m_stdin_event{.events = EPOLLIN, .data = {} };
-    struct epoll_event m_timer_event{.events = EPOLLIN, .data = {} };
-    struct epoll_event m_actual_event{}; ///< Used in epoll_wait().
-    short m_epoll_event_count{};         ///< Number of ready epoll events.
-    static constexpr uint8_t s_MAX_EPOLL_EVENT_NUMBER{1}; ///< Max number of events to process at once.
+    /// @return Traffic of the session so far.
+    const Session_stats& getStats() const;
 
-    std::string m_msg_to_server{};          ///< Message prepared to be sent to the server.
-    std::unique_ptr<char[]> m_server_msg{}; ///< Raw buffer to receive message from server.
+    /// @return Receive batching of the session so far (empty for TCP sessions).
+    virtual Receive_stats getReceiveStats() const;
 
     /**
-     * @brief Handles non-MSG user commands.
-     * @param user_input Parsed user input.
-     * @return True if handled successfully, false otherwise.
+     * @brief Virtual destructor.
      */
-    bool processNonMsgToServer(const std::vector<std::string>& user_input);
+    virtual ~Client();
 
     /**
-     * @brief Reads and parses user input from stdin.
-     * @return Vector of parsed tokens.
+     * @brief Handles SIGINT (Ctrl+C): the session says goodbye to the server, or terminates at once if there is no one
+     * to say it to yet.
+     * @return Whether the session keeps running (a UDP session waits for the CONFIRM of its BYE).
      */
-    std::vector<std::string> parseUserInput();
+    Session_outcome sigintHandler();
 
     /**
-     * @brief Starts the confirm/reply timer.
-     * @param time Timeout in milliseconds.
+     * @brief Reports an error the session has terminated with (called by Event_loop).
+     * @param err_msg The error without the "ERROR: " prefix.
      */
-    void startTimer(uint16_t time);
+    void reportError(std::string_view err_msg);
 
     /**
-     * @brief Stops the reply timer.
+     * @brief Reports the termination of the session (called by Event_loop).
+     * @param is_success True if the session has terminated without an error.
      */
-    void stopTimer();
+    void reportClose(bool is_success);
 
-    /**
-     * @brief Disables stdin events from epoll.
-     */
-    void disableStdinEvents();
+    /// Capacity of the standard input queue (twice the longest valid line).
+    static constexpr std::size_t s_STDIN_BUFFER_SIZE{2 * (Protocol_session::s_MSG_CONTENT_MAX_LENGTH + 1)};
 
-    /**
-     * @brief Re-enables stdin events in epoll.
-     */
-    void enableStdinEvents();
+protected:
+    Args m_args; ///< Parsed arguments.
+    Event_loop& m_event_loop; ///< Loop dispatching the events of the session.
 
-    /**
-     * @brief Gets the message type associated with a command string.
-     * @param command Command as a string_view.
-     * @return Corresponding Protocol_msg_type.
-     */
-    Protocol_msg_type getUserMsgType(std::string_view command) const;
+    // File descriptors
+    int m_client_socket{-1}; ///< Socket file descriptor (-1 until the server address is resolved, for TCP until connected).
+    int m_timer_fd{};      ///< Timer file descriptor.
 
-    /**
-     * @brief Builds a message from user input to send to the server.
-     * @param user_input Parsed input from user.
-     */
-    void buildUserMsgToServer(const std::vector<std::string>& user_input);
+    /// @return Protocol core of the session.
+    virtual Protocol_session& getSession() = 0;
 
-    /**
-     * @brief Prints an error message received from the server.
-     */
-    void printErrFromServer(std::string display_name, std::string message_content) const;
+    /// @return Protocol core of the session.
+    const Protocol_session& getSession() const;
 
-    /**
-     * @brief Prints a received chat message.
-     */
-    void outputIncomingMsg(std::string display_name, std::string content) const;
+    /// @return Protocol parameters given by the command line arguments.
+    Session_config getSessionConfig() const;
 
     /**
-     * @brief Prints a received reply message.
+     * @brief Performs the actions returned by the protocol core.
+     * @param actions The actions.
+     * @return Whether the session keeps running (A_CLOSE terminates it).
      */
-    void outputIncomingReply(bool is_positive, std::string content) const;
+    Session_outcome executeActions(const Action_list& actions);
 
     /**
-     * @brief Validates display name length.
+     * @brief Starts a named timer of the client (not of the protocol).
+     * @param name Name passed to processTimerEvent() when the timer expires.
+     * @param timeout Time until the expiration.
+     * @return Handle of the timer used to stop it.
      */
-    bool isValidDisplayNameLength(unsigned display_name_length) const;
+    Timer_wheel::Timer_handle startTimer(Timer_name name, std::chrono::milliseconds timeout);
 
     /**
-     * @brief Validates message content length.
+     * @brief Stops a named timer. Does nothing if the timer has already expired or been stopped.
+     * @param handle Handle of the timer, invalidated by the call.
      */
-    bool isValidMsgContentLength(unsigned msg_content_length) const;
-
-    /// Max limits
-    static constexpr uint16_t s_MSG_CONTENT_MAX_LENGTH{60000};
-    static constexpr uint8_t s_DISPLAY_NAME_MAX_LENGTH{20};
-    static constexpr uint8_t s_USERNAME_MAX_LENGTH{20};
-    static constexpr uint8_t s_CHANEL_ID_MAX_LENGTH{20};
-    static constexpr uint8_t s_USER_SECRET_MAX_LENGTH{128};
+    void stopTimer(Timer_wheel::Timer_handle& handle);
 
     /**
-     * @brief Gets a regex-compatible set of allowed characters: alphanumerics, underscore, and dash.
+     * @brief Creates the UDP socket for the family of the resolved server address and adds it to the epoll instance
+     * (TCP sockets are created by the connection attempts).
+     * @return Whether the session keeps running (it fails if the socket couldn't be created).
      */
-    static const std::string& getAlphaNumericUnderlineDash();
+    Session_outcome createClientSocket();
 
     /**
-     * @brief Gets printable ASCII characters (excluding space and LF).
+     * @brief Records that a message couldn't be sent (e.g. EPIPE once the server has closed the connection). Further
+     * messages are dropped and the failure is passed to the protocol core once the current actions have been performed.
+     * @param reason Description of the failure (a string literal).
      */
-    static const std::string& getPrintableChars();
+    void setSendError(const char* reason);
 
     /**
-     * @brief Gets printable ASCII characters including space and LF.
+     * @brief Passes the recorded send failure to the protocol core as a transport error.
+     * @return The session has terminated (nothing can be sent to the server any more).
      */
-    static const std::string& getPrintableCharsSpaceLf();
+    Session_outcome processSendError();
 
-private:
-    /**
-     * @brief Builds an ERR message.
-     */
-    virtual void buildErrMsg(std::string content) = 0;
+    /// @return True while the terminated protocol core waits for its last messages to be sent (see finishSending()).
+    bool isClosing() const;
+
+    /// @return The outcome the session terminates with once its last messages have been sent (valid if isClosing()).
+    Session_outcome getClosingOutcome() const;
 
+private:
     /**
-     * @brief Builds an AUTH message.
+     * @brief Sends a message to the server (A_SEND).
+     * @param msg The message; its parts are valid until the next call of the session.
      */
-    virtual void buildAuthMsg(const std::string& username, const std::string& secret) = 0;
+    virtual void sendMsgToServer(Outbound_msg& msg) = 0;
 
     /**
-     * @brief Builds a JOIN message.
+     * @brief Sends whatever the socket accepts without blocking before the session terminates.
+     * @return False if some messages are still queued; the derived class then terminates the session with
+     *         getClosingOutcome() once they are sent, so that the loop keeps serving the other sessions meanwhile.
      */
-    virtual void buildJoinMsg(const std::string& channel_id) = 0;
+    virtual bool finishSending() = 0;
 
     /**
-     * @brief Builds a MSG message.
+     * @brief Switches to the address the server has sent the processed datagram from (A_FOLLOW_PEER).
+     * @return Whether the session keeps running.
      */
-    virtual void buildMsgMsg(const std::string& user_msg) = 0;
+    virtual Session_outcome followPeer();
 
     /**
-     * @brief Builds a BYE message.
+     * @brief Processes the expiration of a named timer of the client.
+     * @param name Name the timer was started with.
+     * @return Whether the session keeps running.
      */
-    virtual void buildByeMsg() = 0;
+    virtual Session_outcome processTimerEvent(Timer_name name);
 
     /**
-     * @brief Sends the current message to the server.
+     * @brief Processes socket events.
+     * @param events Ready event flags of the socket reported by epoll_wait().
+     * @return Whether the session keeps running.
      */
-    virtual void sendMsgToServer() = 0;
+    virtual Session_outcome processSocketEvent(uint32_t events) = 0;
 
     /**
-     * @brief Processes timer expiration events.
+     * @brief Starts communicating with the server once its addresses are available through Args::getServerAddrs().
+     * @return Whether the session keeps running.
      */
-    virtual void processTimerEvent() = 0;
-
+    virtual Session_outcome processServerAddrsResolved() = 0;
 
     /**
-     * @brief Processes socket events.
-     * @return uint8_t 0 if EXIT_SUCCESS needs to be returned from main(), 1 if EXIT_FAILURE needs to be returned from main(),
-     * 2 if client's loop needs to be continued
+     * @brief Processes an event of a socket of a TCP connection attempt (any file descriptor other than stdin, the socket,
+     * the timer and the resolver).
+     * @param socket File descriptor the event has been reported for.
+     * @param events Ready event flags of the file descriptor.
+     * @return Whether the session keeps running.
      */
-    virtual uint8_t processSocketEvent() = 0;
+    virtual Session_outcome processConnectEvent(int socket, uint32_t events);
 
     /**
-     * @brief Handles stdin client's input.
+     * @brief Checks if the next line of user input may be processed (otherwise it stays queued).
+     * @return True once the socket exists and while the protocol core expects input.
      */
-    virtual void processStdinEvent() = 0;
+    virtual bool isUserInputEnabled();
 
     /**
-     * @brief Handles SIGINT (Ctrl+C).
+     * @brief Passes a message received from the server (A_RECEIVE) to its callback.
+     * @param action The action.
      */
-    virtual void sigintHandler() = 0;
-
+    void reportReceivedMsg(const Protocol_action& action);
 
     /**
      * @brief Creates the timer file descriptor.
@@ -238,49 +236,75 @@ private:
     void createTimerFd();
 
     /**
-     * @brief Checks if the client can currently send a message of the given type.
+     * @brief Reads all available user input into the queue.
+     * @param events Ready event flags of the input reported by epoll_wait().
+     * @return Whether the session keeps running (it fails if the input couldn't be read).
      */
-    bool canSendMessageType(Protocol_msg_type msg_type) const;
+    Session_outcome processStdinEvent(uint32_t events);
 
     /**
-     * @brief Creates the socket used for communication.
+     * @brief Processes queued lines of user input while it is enabled, then handles the end of input if it was reached.
+     * @return Whether the session keeps running.
      */
-    void createClientSocket();
+    Session_outcome processQueuedUserInput();
 
     /**
-     * @brief Prints supported user commands to stdout.
+     * @brief Watches the input in epoll only if more input can be queued, so that a full queue or closed stdin
+     * doesn't wake the loop up repeatedly.
      */
-    void printSupportedCommands() const;
+    void updateStdinRegistration();
 
     /**
-     * @brief Adds socket, stdin, and timer to the epoll instance.
+     * @brief Consumes the expiration count of the timer and processes the expired timers of the client and of the
+     * protocol core (none if the timer was stopped or restarted after its expiration had been reported by epoll_wait()).
+     * @return Whether the session keeps running.
      */
-    void addEntriesToEpollInstance();
+    Session_outcome processTimerExpiration();
 
     /**
-     * @brief Creates the epoll instance.
+     * @brief Arms the timer file descriptor to the earliest deadline of the client and of the protocol core,
+     * or disarms it if there is none.
+     * @return Whether the session keeps running (it fails if the timer couldn't be armed).
      */
-    void createEpollFd();
+    Session_outcome updateTimerFd();
 
     /**
-     * @brief Adds a file descriptor to epoll with the given event configuration.
+     * @brief Stores the resolved server addresses and lets the derived class start communicating.
+     * @return Whether the session keeps running (it fails if the hostname couldn't be resolved).
      */
-    void addFileDescriptorToEpollEvent(struct epoll_event& event, int file_descriptor);
+    Session_outcome processResolverEvent();
 
     /**
-     * @brief Extracts and tokenizes user input using regex match results.
+     * @brief Adds the input, the timer and the resolver to the event loop.
      */
-    std::vector<std::string> getUserInput(const std::smatch& user_input_matches) const;
-
-    /// Regex matchers for user commands
-    static const std::regex& getAuthCommandRegex();
-    static const std::regex& getJoinCommandRegex();
-    static const std::regex& getRenameCommandRegex();
-    static const std::regex& getHelpCommandRegex();
-    static const std::regex& getUserMsgRegex();
+    void addEntriesToEpollInstance();
 
-    /// SIGINT callback handler (used with signal())
-    static std::function<void()> m_sigint_callback;
+    /**
+     * @brief Wakes the session up by a timer when the next line of user input is delayed (think time of a load session).
+     */
+    void scheduleDelayedInput();
+
+    std::shared_ptr<Input_source> m_input_source;        ///< Queue of user input.
+    int m_input_fd;                                      ///< File descriptor of the input (-1 if it has none).
+    Host_resolver m_host_resolver{};                     ///< Resolves the server hostname without blocking the loop.
+    bool m_is_resolver_registered{false};                ///< True while the resolver is in the event loop.
+    bool m_is_stdin_registered{false};                   ///< True if the input is in the event loop.
+    bool m_is_stdin_eof_processed{false};                ///< True once the end of input has been passed to the session.
+    Chat_callbacks m_callbacks;                          ///< Receivers of the output of the session.
+    Timer_wheel m_timer_wheel{};                         ///< Deadlines of the client (connection attempts, delayed input).
+    std::vector<Timer_name> m_expired_timers{};          ///< Names of timers expired at the last timer event.
+    std::optional<Timer_wheel::Clock::time_point> m_session_deadline{}; ///< Deadline of the protocol core's timers.
+    std::optional<Timer_wheel::Clock::time_point> m_timer_fd_deadline{}; ///< Deadline the timer file descriptor is armed to.
+    Timer_wheel::Timer_handle m_input_timer{Timer_wheel::s_INVALID_HANDLE}; ///< Timer of the delayed line of user input.
+    const char* m_send_error{nullptr};                   ///< Failure of sending recorded by setSendError() (nullptr if none).
+    bool m_is_send_error_processed{false};               ///< True once the failure has been passed to the protocol core.
+    std::optional<Session_outcome> m_closing_outcome{};  ///< Outcome of A_CLOSE while the last messages are being sent.
+
+    // Events recorded by processEvent()
+    uint32_t m_socket_events{0};   ///< Ready event flags of the socket.
+    uint32_t m_timer_events{0};    ///< Ready event flags of the timer.
+    uint32_t m_input_events{0};    ///< Ready event flags of the input.
+    bool m_is_resolver_ready{false}; ///< True if the resolver has signalled the result.
 };
 
 #endif
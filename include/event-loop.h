@@ -0,0 +1,169 @@
+/**
+ * @file event-loop.h
+ * @author Andrii Klymenko
+ * @brief Epoll loop shared by any number of client sessions.
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "session-outcome.h"
+#include "session-stats.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Client;
+class Exception;
+
+/**
+ * @class Event_loop
+ * @brief Waits for the events of all file descriptors of its sessions with one epoll instance and dispatches them.
+ *
+ * Every registered file descriptor has an owning session. Events reported by one epoll_wait() are first passed to their
+ * sessions, then every session with some event processes them at once in its own priority order, so a session behaves
+ * the same as if it had its own loop. A session terminates by returning a finished Session_outcome from a handler; it is
+ * destroyed without affecting the others (so is a session whose system call has failed with an Exception).
+ * SIGINT is received through a signalfd and passed to every session. A loop run by a worker thread of Sharded_executor
+ * doesn't receive SIGINT itself, the executor passes it by interrupt() instead. The loop itself writes nothing; a program
+ * buffering the output of its callbacks flushes it by a hook called before every wait (see setBeforeWaitHook()).
+ */
+class Event_loop {
+public:
+    /**
+     * @brief Creates the epoll instance and the eventfd signalled by interrupt().
+     * @param is_sigint_received True to block SIGINT in the calling thread and receive it by a signalfd of the loop.
+     */
+    explicit Event_loop(bool is_sigint_received = true);
+
+    /**
+     * @brief Destroys the remaining sessions and closes the epoll instance.
+     */
+    ~Event_loop();
+
+    Event_loop(const Event_loop&) = delete;
+    Event_loop& operator=(const Event_loop&) = delete;
+
+    /**
+     * @brief Takes over a session; it processes its first events in the next iteration of run().
+     * @param session Constructed session (its file descriptors are already registered).
+     */
+    void addSession(std::unique_ptr<Client> session);
+
+    /**
+     * @brief Registers a file descriptor of a session.
+     * @param file_descriptor File descriptor to watch.
+     * @param events Epoll event flags to watch for.
+     * @param owner Session the events are passed to.
+     */
+    void add(int file_descriptor, uint32_t events, Client& owner);
+
+    /**
+     * @brief Changes the event flags of a registered file descriptor.
+     * @param file_descriptor Registered file descriptor.
+     * @param events Epoll event flags to watch for.
+     */
+    void modify(int file_descriptor, uint32_t events);
+
+    /**
+     * @brief Unregisters a file descriptor (before it is closed or passed to another owner).
+     * @param file_descriptor Registered file descriptor.
+     */
+    void remove(int file_descriptor);
+
+    /**
+     * @brief Sets a function called by run() every time before it waits for events (the interactive client writes its
+     * buffered output lines by it).
+     * @param hook The function (empty to call none).
+     */
+    void setBeforeWaitHook(std::function<void()> hook);
+
+    /**
+     * @brief Runs until all sessions have terminated.
+     */
+    void run();
+
+    /// @return Totals of the terminated sessions.
+    const Loop_stats& getStats() const;
+
+    /**
+     * @brief Passes SIGINT to every session as if the loop has received it; may be called from any thread.
+     */
+    void interrupt();
+
+    /**
+     * @brief Blocks SIGINT in the calling thread (threads started later inherit the mask) and creates a signalfd receiving it.
+     * @return The signalfd.
+     */
+    static int createSigintFd();
+
+private:
+    /// Max number of events processed after one epoll_wait().
+    static constexpr int s_MAX_EPOLL_EVENT_NUMBER{256};
+
+    /**
+     * @brief Registers the signalfd or the eventfd of interrupt() (they have no owning session).
+     * @param file_descriptor The file descriptor.
+     */
+    void addOwnFileDescriptor(int file_descriptor);
+
+    /**
+     * @brief Closes the epoll instance, the signalfd and the eventfd of interrupt().
+     */
+    void closeOwnFileDescriptors();
+
+    /**
+     * @brief Lets every session that received some event process them, then destroys the terminated sessions.
+     */
+    void processReadySessions();
+
+    /**
+     * @brief Reads the signalfd or the eventfd of interrupt() and passes SIGINT to every session.
+     * @param file_descriptor The ready file descriptor.
+     */
+    void processSigint(int file_descriptor);
+
+    /**
+     * @brief Marks a session as ready to process its events in this iteration.
+     */
+    void markReady(Client& session);
+
+    /**
+     * @brief Terminates a session whose handler has returned a finished outcome; the reason of a failure is reported
+     * by the session's callbacks.
+     * @param session The session.
+     * @param outcome The outcome.
+     */
+    void finishSession(Client& session, const Session_outcome& outcome);
+
+    /**
+     * @brief Terminates a session that has thrown an exception (a failed system call); the error is reported by the
+     * session's callbacks.
+     * @param session The session.
+     * @param exception The exception.
+     */
+    void finishSession(Client& session, const Exception& exception);
+
+    /**
+     * @brief Accounts a terminated session, reports its termination and schedules its destruction at the end of the
+     * iteration.
+     * @param session The session.
+     * @param is_success True if the session has terminated without an error.
+     */
+    void finishSession(Client& session, bool is_success);
+
+    int m_epoll_fd{-1};     ///< Epoll instance.
+    int m_signal_fd{-1};    ///< Signalfd receiving SIGINT (-1 if SIGINT is passed by interrupt()).
+    int m_interrupt_fd{-1}; ///< Eventfd signalled by interrupt().
+
+    std::vector<Client*> m_fd_owners{};                                ///< Owning session of each registered file descriptor.
+    std::unordered_map<Client*, std::unique_ptr<Client>> m_sessions{}; ///< Running sessions.
+    std::vector<Client*> m_ready_sessions{};                           ///< Sessions with events in this iteration.
+    std::vector<std::unique_ptr<Client>> m_finished_sessions{};        ///< Sessions terminated in this iteration.
+    Loop_stats m_stats{};                                              ///< Totals of the terminated sessions.
+    std::function<void()> m_before_wait_hook{};                        ///< Called before every wait for events.
+};
+
+#endif // EVENT_LOOP_H
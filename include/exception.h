@@ -32,9 +32,6 @@ public:
      * @return string containing exception's cause
      */
     const char* what() const noexcept override;
-
-
-    bool isSigintOrEofReceived() const;
 };
 
 #endif // EXCEPTION_H
@@ -0,0 +1,125 @@
+/**
+ * @file host-resolver.h
+ * @author Andrii Klymenko
+ * @brief Resolution of the server's hostname that doesn't block the client loop.
+ */
+
+#ifndef HOST_RESOLVER_H
+#define HOST_RESOLVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h> // struct sockaddr_storage
+
+/**
+ * @class Host_resolver
+ * @brief Resolves a hostname to IPv4 and IPv6 addresses in a helper thread that signals the completion through an eventfd.
+ *
+ * The eventfd is registered in the client's epoll instance, so the client keeps accepting user input while resolving.
+ * Numeric addresses are converted at once and resolved hostnames are cached for s_CACHE_TTL, so these don't start any thread;
+ * the eventfd is signalled in either case. Resolvers asking for a hostname that is already being resolved wait for the same
+ * helper thread, so many load sessions starting at once perform a single lookup. The helper thread is detached and shares the result with the resolver, so
+ * a client terminating during a slow resolution doesn't wait for it; the cache it completes is therefore never destroyed.
+ */
+class Host_resolver {
+public:
+    /**
+     * @brief Creates the eventfd.
+     */
+    Host_resolver();
+
+    Host_resolver(const Host_resolver&) = delete;
+    Host_resolver& operator=(const Host_resolver&) = delete;
+
+    /// @return File descriptor that becomes readable when the result is available.
+    int getEventFd() const;
+
+    /**
+     * @brief Starts resolving a hostname or converting a numeric address. If the helper thread can't be started,
+     * the resolution completes with no addresses.
+     * @param hostname Hostname, IPv4 or IPv6 address (possibly with a zone index).
+     * @param port Port stored in the resulting addresses.
+     */
+    void resolve(const std::string& hostname, uint16_t port);
+
+    /**
+     * @brief Gets the result once the eventfd is readable.
+     * @return Resolved addresses in the order of preference (none if the hostname couldn't be resolved).
+     */
+    std::vector<struct sockaddr_storage> getResult();
+
+private:
+    /**
+     * @brief State shared with the helper thread.
+     */
+    struct Resolution;
+
+    /**
+     * @brief Cached addresses of a hostname.
+     */
+    struct Cache_entry {
+        std::vector<struct sockaddr_storage> addrs{};       ///< Resolved addresses.
+        std::chrono::steady_clock::time_point expires_at{}; ///< When the addresses have to be resolved again.
+    };
+
+    /// Time resolved addresses are reused for (getaddrinfo() doesn't report the TTL of DNS records)
+    static constexpr std::chrono::seconds s_CACHE_TTL{60};
+
+    /**
+     * @brief Calls getaddrinfo() and collects IPv4 and IPv6 addresses.
+     * @param hostname Hostname or numeric address.
+     * @param port Port as a string.
+     * @param flags getaddrinfo() flags (AI_NUMERICHOST to avoid any lookup).
+     * @param addrs Filled with the addresses.
+     * @return 0 on success, otherwise a getaddrinfo() error code.
+     */
+    static int getAddresses(const std::string& hostname, const std::string& port, int flags,
+                            std::vector<struct sockaddr_storage>& addrs);
+
+    /**
+     * @brief Body of the helper thread; completes every resolution waiting for the hostname.
+     * @param hostname Hostname to resolve.
+     * @param port Port as a string.
+     */
+    static void runResolution(std::string hostname, std::string port);
+
+    /**
+     * @brief Caches a successful result and completes every resolution waiting for the hostname.
+     * @param key Hostname and port ("hostname port").
+     * @param error 0 on success, otherwise a getaddrinfo() error code.
+     * @param addrs Resolved addresses.
+     */
+    static void completePending(const std::string& key, int error, std::vector<struct sockaddr_storage> addrs);
+
+    /**
+     * @brief Stores the result and signals the eventfd.
+     * @param resolution State shared with the resolver.
+     * @param error 0 on success, otherwise a getaddrinfo() error code.
+     * @param addrs Resolved addresses.
+     */
+    static void complete(Resolution& resolution, int error, std::vector<struct sockaddr_storage> addrs);
+
+    /**
+     * @brief Cache and pending resolutions shared by all resolvers and helper threads.
+     */
+    struct Shared_state {
+        std::mutex mutex{};                                   ///< Guards the state (sessions may run in several threads).
+        std::unordered_map<std::string, Cache_entry> cache{}; ///< Resolved hostnames keyed by "hostname port".
+        std::unordered_map<std::string, std::vector<std::shared_ptr<Resolution>>> pending{}; ///< Resolutions waiting for a helper thread, same keys.
+    };
+
+    /**
+     * @brief Gets the state shared by all resolvers. It is allocated once and never destroyed, so a helper thread
+     * completing after main() has returned doesn't touch a destroyed object.
+     */
+    static Shared_state& getSharedState();
+
+    std::shared_ptr<Resolution> m_resolution; ///< State shared with the helper thread.
+};
+
+#endif // HOST_RESOLVER_H
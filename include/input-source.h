@@ -0,0 +1,66 @@
+/**
+ * @file input-source.h
+ * @author Andrii Klymenko
+ * @brief Interface of the sources of the lines of user input processed by a client session.
+ */
+
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ * @class Input_source
+ * @brief Queue of user input lines (the standard input of an interactive client or the script of a load session).
+ */
+class Input_source {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Result of the extraction of a line.
+     */
+    enum class Line_status : uint8_t
+    {
+        L_NONE,     ///< No complete line is available.
+        L_LINE,     ///< A line has been extracted.
+        L_TOO_LONG, ///< A line longer than the buffer has been skipped.
+    };
+
+    virtual ~Input_source() = default;
+
+    /// @return File descriptor to watch for more input, or -1 if the whole input is available without reading.
+    virtual int getFileDescriptor() const = 0;
+
+    /**
+     * @brief Reads available input; called when the file descriptor is readable.
+     * @return False if reading has failed.
+     */
+    virtual bool read() = 0;
+
+    /**
+     * @brief Extracts the next line (without LF).
+     * @param line Set to a view of the line; valid until the next call of read() or nextLine().
+     */
+    virtual Line_status nextLine(std::string_view& line) = 0;
+
+    /// @return True if no more input can be buffered until some lines are extracted.
+    virtual bool isFull() const = 0;
+
+    /// @return True if the end of input has been read.
+    virtual bool isEofRead() const = 0;
+
+    /// @return True if the end of input has been read and all lines have been extracted.
+    virtual bool isEof() const = 0;
+
+    /// @return Time the next line (or the end of input) is delayed until, or nothing if it isn't delayed.
+    virtual std::optional<Clock::time_point> getNextLineTime() const
+    {
+        return {};
+    }
+};
+
+#endif // INPUT_SOURCE_H
@@ -0,0 +1,19 @@
+/**
+ * @file ipk25chat.h
+ * @author Andrii Klymenko
+ * @brief Public interface of the libipk25chat library (IPK25-CHAT client sessions embedded into another program).
+ *
+ * A program creates an Event_loop{false}, any number of sessions by Chat_session::create() and runs the loop by
+ * Event_loop::run() in a thread of its own; Chat_session::send() and Chat_session::close() may be called by any thread.
+ */
+
+#ifndef IPK25CHAT_H
+#define IPK25CHAT_H
+
+#include "args.h"
+#include "chat-callbacks.h"
+#include "chat-session.h"
+#include "client.h" // Event_loop owns the sessions, so their type has to be complete
+#include "event-loop.h"
+
+#endif // IPK25CHAT_H
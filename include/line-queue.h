@@ -0,0 +1,90 @@
+/**
+ * @file line-queue.h
+ * @author Andrii Klymenko
+ * @brief Queue of user input lines pushed by the program embedding the client.
+ */
+
+#ifndef LINE_QUEUE_H
+#define LINE_QUEUE_H
+
+#include "input-source.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @class Line_queue
+ * @brief User input of a session embedded into another program: lines are pushed by any thread and extracted by
+ * the thread running the session's Event_loop.
+ *
+ * Every push wakes the loop up through an eventfd, which is the file descriptor of the input. Pushed lines are kept
+ * in a separate buffer guarded by a mutex and moved to the buffer of extracted lines by read(), so the loop holds
+ * the mutex only while moving them.
+ */
+class Line_queue : public Input_source {
+public:
+    /**
+     * @brief Creates the eventfd.
+     */
+    Line_queue();
+
+    /**
+     * @brief Closes the eventfd.
+     */
+    ~Line_queue() override;
+
+    Line_queue(const Line_queue&) = delete;
+    Line_queue& operator=(const Line_queue&) = delete;
+
+    /**
+     * @brief Appends a line (a command or a chat message, without LF). Thread-safe.
+     * @param line The line; it is copied.
+     */
+    void push(std::string_view line);
+
+    /**
+     * @brief Ends the input: once the pushed lines are processed, the session says BYE. Thread-safe.
+     */
+    void close();
+
+    /// @return The eventfd signalled by push() and close().
+    int getFileDescriptor() const override;
+
+    /**
+     * @brief Moves the pushed lines to the lines to be extracted. Invalidates all lines extracted so far.
+     * @return True, moving the lines can't fail.
+     */
+    bool read() override;
+
+    /**
+     * @brief Extracts the next line.
+     * @param line Set to a view of the line; valid until the next call of read().
+     */
+    Line_status nextLine(std::string_view& line) override;
+
+    /// @return False, the queue isn't limited.
+    bool isFull() const override;
+
+    /// @return True once read() has seen close().
+    bool isEofRead() const override;
+
+    /// @return True if the end of input has been read and all lines have been extracted.
+    bool isEof() const override;
+
+private:
+    /**
+     * @brief Signals the eventfd.
+     */
+    void wakeUp();
+
+    int m_event_fd;                 ///< Wakes the loop up when a line is pushed.
+    std::mutex m_mutex;             ///< Guards the pushed lines and the close request.
+    std::string m_pushed{};         ///< Pushed lines, each terminated by LF.
+    bool m_is_close_pushed{false};  ///< True once close() has been called.
+    std::string m_lines{};          ///< Lines moved by read(), each terminated by LF.
+    std::size_t m_begin{0};         ///< Start of the first not extracted line.
+    bool m_is_eof_read{false};      ///< True once read() has seen close().
+};
+
+#endif // LINE_QUEUE_H
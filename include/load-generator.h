@@ -0,0 +1,64 @@
+/**
+ * @file load-generator.h
+ * @author Andrii Klymenko
+ * @brief Load testing mode running many scripted client sessions in one process.
+ */
+
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "args.h"
+#include "session-stats.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class Load_generator
+ * @brief Runs -n independent TCP or UDP sessions on one Event_loop per CPU (Sharded_executor), each fed by a Script_reader,
+ * and prints their totals.
+ *
+ * Sessions share no state except the script and the cache of resolved hostnames. They don't print received messages,
+ * they only count them; errors are still printed to stderr.
+ */
+class Load_generator {
+public:
+    /**
+     * @brief Constructs the generator.
+     * @param args Command line arguments (with -n and -f).
+     */
+    explicit Load_generator(const Args& args);
+
+    /**
+     * @brief Runs all sessions until they terminate and prints their totals.
+     * @return True if all sessions have terminated successfully.
+     */
+    bool run();
+
+private:
+    /**
+     * @brief Reads the script of the sessions.
+     * @param path Path to the script.
+     * @return Lines of the script without LF.
+     */
+    static std::shared_ptr<const std::vector<std::string>> readScript(const std::string& path);
+
+    /**
+     * @brief Raises the soft limit of open file descriptors to the hard limit (every session needs several of them).
+     */
+    static void raiseFileDescriptorLimit();
+
+    /**
+     * @brief Prints the totals of all sessions to stdout.
+     * @param stats Totals of the sessions.
+     * @param loop_count Number of threads the sessions have run in.
+     * @param duration Time the sessions have run for.
+     */
+    static void printStats(const Loop_stats& stats, std::size_t loop_count, std::chrono::steady_clock::duration duration);
+
+    Args m_args; ///< Parsed arguments shared by all sessions.
+};
+
+#endif // LOAD_GENERATOR_H
@@ -0,0 +1,56 @@
+/**
+ * @file outbound-msg.h
+ * @author Andrii Klymenko
+ * @brief Message to the server described by views of its parts.
+ */
+
+#ifndef OUTBOUND_MSG_H
+#define OUTBOUND_MSG_H
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <sys/uio.h> // struct iovec
+
+/**
+ * @class Outbound_msg
+ * @brief Gathers the parts of a message (literals, the display name, the user input, ...) as iovecs for sendmsg().
+ *
+ * The parts aren't copied, so they have to stay valid until the message is sent; a contiguous copy is made only
+ * where the message has to outlive them (UDP retransmission).
+ */
+class Outbound_msg {
+public:
+    /// Maximal number of non-empty parts of a message
+    static constexpr std::size_t s_MAX_PARTS{8};
+
+    /**
+     * @brief Replaces the message with the given parts.
+     * @param parts Fields and delimiters of the message in wire order.
+     */
+    void assign(std::initializer_list<std::string_view> parts);
+
+    /// @return The parts as an array of getPartCount() iovecs.
+    struct iovec* getIovecs();
+
+    /// @return Number of the parts.
+    std::size_t getPartCount() const;
+
+    /// @return Total size of the message in bytes.
+    std::size_t getSize() const;
+
+    /**
+     * @brief Copies the whole message into a string.
+     * @param destination String to be overwritten by the message.
+     */
+    void copyTo(std::string& destination) const;
+
+private:
+    std::array<struct iovec, s_MAX_PARTS> m_parts{}; ///< Parts of the message.
+    std::size_t m_part_count{0};                     ///< Number of the parts.
+    std::size_t m_size{0};                           ///< Total size of the parts.
+};
+
+#endif // OUTBOUND_MSG_H
@@ -0,0 +1,75 @@
+/**
+ * @file output-writer.h
+ * @author Andrii Klymenko
+ * @brief Buffered writer of the client's output lines.
+ */
+
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+/**
+ * @class Output_writer
+ * @brief Collects output lines in a reusable buffer and writes them with as few system calls as possible.
+ *
+ * The buffer is written by flush(), which the interactive client calls once per loop iteration, or as soon as it is full.
+ * If the file descriptor is a terminal, every line is written immediately. Lines containing a large part
+ * (e.g. a long message content) are written by a single writev() call together with the buffered data,
+ * so the large part is never copied.
+ */
+class Output_writer {
+public:
+    /**
+     * @brief Constructs a writer of the given file descriptor.
+     * @param file_descriptor File descriptor to write to.
+     */
+    explicit Output_writer(int file_descriptor);
+
+    /**
+     * @brief Writes all buffered data.
+     */
+    ~Output_writer();
+
+    Output_writer(const Output_writer&) = delete;
+    Output_writer& operator=(const Output_writer&) = delete;
+
+    /// @return Writer of the standard output used by the calling thread (the buffer is flushed when the thread exits).
+    static Output_writer& getStdout();
+
+    /**
+     * @brief Appends a line consisting of the given parts followed by LF.
+     * @param parts Parts of the line; they are not referenced after the call returns.
+     */
+    void writeLine(std::initializer_list<std::string_view> parts);
+
+    /**
+     * @brief Writes all buffered data to the file descriptor.
+     */
+    void flush();
+
+private:
+    /// Parts of at least this size are passed to writev() instead of being copied into the buffer.
+    static constexpr std::size_t s_LARGE_PART_SIZE{4096};
+
+    /// Number of buffered bytes after which the buffer is written without waiting for flush().
+    static constexpr std::size_t s_BUFFER_CAPACITY{64 * 1024};
+
+    /// Maximal number of parts of a line written by writev().
+    static constexpr std::size_t s_MAX_LINE_PARTS{6};
+
+    int m_file_descriptor;      ///< File descriptor to write to.
+    bool m_is_line_buffered;    ///< True if the file descriptor is a terminal.
+    std::string m_buffer{};     ///< Data not written yet.
+
+    /**
+     * @brief Writes the buffered data followed by the parts of a line using one writev() call (if possible).
+     * @param parts Parts of the line (at most s_MAX_LINE_PARTS).
+     */
+    void writeLineDirectly(std::initializer_list<std::string_view> parts);
+};
+
+#endif // OUTPUT_WRITER_H
@@ -0,0 +1,51 @@
+/**
+ * @file protocol-action.h
+ * @author Andrii Klymenko
+ * @brief Actions requested by the protocol core from the code performing its I/O.
+ */
+
+#ifndef PROTOCOL_ACTION_H
+#define PROTOCOL_ACTION_H
+
+#include "outbound-msg.h"
+#include "protocol-msg-type.h"
+#include <chrono>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Kinds of actions returned by Protocol_session.
+ */
+enum class Action_type
+{
+    A_SEND,        ///< Send the message to the server (a whole TCP message or one UDP datagram).
+    A_RECEIVE,     ///< Deliver a MSG, REPLY or ERR message received from the server to the user.
+    A_PRINT,       ///< Show a local text to the user (the help).
+    A_PRINT_ERROR, ///< Report a local error message (without the "ERROR: " prefix).
+    A_SET_TIMER,   ///< Call processTimers() at the deadline (replaces the previous deadline, none disarms it).
+    A_FOLLOW_PEER, ///< UDP: the server continues from the address of the datagram just processed.
+    A_CLOSE,       ///< The session has terminated; no other action follows.
+};
+
+/**
+ * @brief One action; only the fields of its type are set.
+ *
+ * Views (the parts of the message and the texts) refer to the input passed to the session or to the session itself
+ * and are valid until the next call of the session, so actions have to be performed before it.
+ */
+struct Protocol_action {
+    Action_type type{Action_type::A_SEND};                           ///< Kind of the action.
+    Outbound_msg msg{};                                              ///< A_SEND: parts of the message.
+    Protocol_msg_type msg_type{Protocol_msg_type::M_UNKNOWN};        ///< A_RECEIVE: M_MSG, M_REPLY or M_ERR.
+    std::string_view display_name{};                                 ///< A_RECEIVE: sender of MSG or ERR.
+    std::string_view content{};                                      ///< A_RECEIVE, A_PRINT, A_PRINT_ERROR: the text.
+    std::optional<std::chrono::steady_clock::time_point> deadline{}; ///< A_SET_TIMER: the deadline.
+    bool is_success{false};                                          ///< A_RECEIVE: positive REPLY; A_CLOSE: no error.
+    std::string_view reason{};                                       ///< A_CLOSE: error to be reported (empty if none).
+};
+
+/// Actions resulting from one input of a session, in the order they have to be performed.
+using Action_list = std::vector<Protocol_action>;
+
+#endif // PROTOCOL_ACTION_H
@@ -0,0 +1,323 @@
+/**
+ * @file protocol-session.h
+ * @author Andrii Klymenko
+ * @brief Protocol core of a client session that performs no I/O (base class of its TCP and UDP versions).
+ */
+
+#ifndef PROTOCOL_SESSION_H
+#define PROTOCOL_SESSION_H
+
+#include "fsm.h"
+#include "protocol-action.h"
+#include "protocol-msg-type.h"
+#include "session-stats.h"
+#include "timer-wheel.h"
+#include "user-input-parser.h"
+#include "outbound-msg.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Protocol parameters of a session (the defaults are the ones of the assignment, except the upper bound of the
+ * adaptive timeout, which leaves room for the exponential backoff up to the REPLY timeout).
+ */
+struct Session_config {
+    std::chrono::milliseconds udp_confirm_timeout{250};      ///< Initial (or fixed) time to wait for a CONFIRM.
+    bool is_udp_confirm_timeout_fixed{false};                ///< True to disable the adaptive confirmation timeout.
+    std::chrono::milliseconds udp_min_confirm_timeout{10};   ///< Lower bound of the adaptive timeout.
+    std::chrono::milliseconds udp_max_confirm_timeout{5000}; ///< Upper bound of the adaptive timeout.
+    uint8_t udp_max_retransmissions{3};                      ///< Retransmissions of a UDP message before giving up.
+    std::size_t udp_window_size{1};                          ///< Max number of unconfirmed UDP messages.
+};
+
+/**
+ * @class Protocol_session
+ * @brief The IPK25-CHAT finite state machine fed with user input, data from the server and the current time.
+ *
+ * Every process*() call returns the actions the caller has to perform (send, print, arm the timer, close). The session
+ * never touches a socket, a file descriptor or the clock, so it can be embedded into any event loop, or run without
+ * any network in simulations and deterministic tests. The caller also decides when user input is read: the next line
+ * is expected only while isUserInputEnabled() returns true.
+ */
+class Protocol_session {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs a session in the START state.
+     * @param now Current time (the origin of the timers).
+     */
+    explicit Protocol_session(Clock::time_point now);
+
+    virtual ~Protocol_session() = default;
+
+    Protocol_session(const Protocol_session&) = delete;
+    Protocol_session& operator=(const Protocol_session&) = delete;
+
+    /**
+     * @brief Creates the TCP or UDP version of a session.
+     * @param is_tcp True for TCP.
+     * @param config Protocol parameters.
+     * @param now Current time.
+     */
+    static std::unique_ptr<Protocol_session> create(bool is_tcp, const Session_config& config, Clock::time_point now);
+
+    /**
+     * @brief Processes one line of user input (a command or a chat message, without LF).
+     * @param line The line; it has to stay valid until the actions are performed.
+     * @param now Current time.
+     */
+    const Action_list& processUserLine(std::string_view line, Clock::time_point now);
+
+    /**
+     * @brief Processes the end of user input (BYE is sent).
+     * @param now Current time.
+     */
+    const Action_list& processUserEof(Clock::time_point now);
+
+    /**
+     * @brief Processes SIGINT (BYE is sent).
+     * @param now Current time.
+     */
+    const Action_list& processSigint(Clock::time_point now);
+
+    /**
+     * @brief Processes the timers that have expired by now (retransmissions, the REPLY timeout).
+     * @param now Current time.
+     */
+    const Action_list& processTimers(Clock::time_point now);
+
+    /**
+     * @brief Processes a failure of the transport (e.g. an error reported for the socket).
+     * @param reason Description of the failure (a string literal).
+     * @param now Current time.
+     */
+    const Action_list& processTransportError(const char* reason, Clock::time_point now);
+
+    /// @return True if the next line of user input may be processed.
+    virtual bool isUserInputEnabled() const = 0;
+
+    /// @return True once the session has returned A_CLOSE; it ignores any further input.
+    bool isClosed() const;
+
+    /// @return Current state of the FSM.
+    FSM_state getState() const;
+
+    /// @return Traffic of the session so far.
+    const Session_stats& getStats() const;
+
+    /// Max limits
+    static constexpr uint16_t s_MSG_CONTENT_MAX_LENGTH{60000};
+    static constexpr uint8_t s_DISPLAY_NAME_MAX_LENGTH{20};
+    static constexpr uint8_t s_USERNAME_MAX_LENGTH{20};
+    static constexpr uint8_t s_CHANEL_ID_MAX_LENGTH{20};
+    static constexpr uint8_t s_USER_SECRET_MAX_LENGTH{128};
+
+    /// Maximum number of seconds to wait for a REPLY message.
+    static constexpr uint8_t s_MAX_REPLY_WAIT_TIME{5};
+
+protected:
+    FSM_state m_current_state{FSM_state::S_START}; ///< Current state of the FSM.
+
+    std::string m_user_display_name{"unknown"}; ///< Display name of the user.
+
+    bool m_is_waiting_for_reply{false}; ///< True if waiting for server REPLY message.
+    Timer_wheel::Timer_handle m_reply_timer{Timer_wheel::s_INVALID_HANDLE}; ///< Timer of the awaited REPLY message.
+
+    /// Message being built for the server; it refers to its parts, which are valid until the actions are performed
+    Outbound_msg m_msg_to_server{};
+
+    Session_stats m_stats{}; ///< Traffic of the session.
+
+    /**
+     * @brief Starts a call of a process*() function.
+     * @param now Current time.
+     * @return False if the session has already been closed (the call returns no action).
+     */
+    bool beginCall(Clock::time_point now);
+
+    /**
+     * @brief Finishes a call: reports the new earliest deadline of the timers if it has changed.
+     * @return The actions of the call.
+     */
+    const Action_list& endCall();
+
+    /// @return Time passed to the current call.
+    Clock::time_point getNow() const;
+
+    /**
+     * @brief Starts a named timer.
+     * @param name Name passed to processTimerEvent() when the timer expires.
+     * @param timeout Time until the expiration.
+     * @return Handle of the timer used to stop it.
+     */
+    Timer_wheel::Timer_handle startTimer(Timer_name name, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Stops a named timer. Does nothing if the timer has already expired or been stopped.
+     * @param handle Handle of the timer, invalidated by the call.
+     */
+    void stopTimer(Timer_wheel::Timer_handle& handle);
+
+    /**
+     * @brief Invalidates the stored handle of an expired timer (the REPLY timer in the base class).
+     * @param name Name the timer was started with.
+     */
+    virtual void forgetExpiredTimer(Timer_name name);
+
+    /**
+     * @brief Requests sending the built message.
+     */
+    void addSendAction();
+
+    /**
+     * @brief Requests sending a message that isn't built into m_msg_to_server (e.g. a retransmission).
+     * @param msg The message.
+     */
+    void addSendAction(const Outbound_msg& msg);
+
+    /**
+     * @brief Requests reporting a local error.
+     * @param err_msg The error without the "ERROR: " prefix.
+     */
+    void addPrintErrorAction(std::string_view err_msg);
+
+    /**
+     * @brief Requests switching to the address the server has sent the processed datagram from.
+     */
+    void addFollowPeerAction();
+
+    /**
+     * @brief Requests terminating the session; the session ignores any further input.
+     * @param is_success True if the session has terminated without an error.
+     * @param reason Error to be reported (empty if none).
+     */
+    void addCloseAction(bool is_success, std::string_view reason);
+
+    /**
+     * @brief Builds a message from user input to send to the server.
+     * @param user_input Parsed input from user.
+     * @return False if the input isn't a message to the server (the session is closed then).
+     */
+    bool buildUserMsgToServer(const User_input& user_input);
+
+    /**
+     * @brief Prints an error message received from the server.
+     */
+    void printErrFromServer(std::string_view display_name, std::string_view message_content);
+
+    /**
+     * @brief Prints a received chat message.
+     */
+    void outputIncomingMsg(std::string_view display_name, std::string_view content);
+
+    /**
+     * @brief Prints a received reply message.
+     */
+    void outputIncomingReply(bool is_positive, std::string_view content);
+
+    /**
+     * @brief Validates display name length.
+     */
+    bool isValidDisplayNameLength(unsigned display_name_length) const;
+
+    /**
+     * @brief Validates message content length.
+     */
+    bool isValidMsgContentLength(unsigned msg_content_length) const;
+
+private:
+    /**
+     * @brief Builds an ERR message.
+     */
+    virtual void buildErrMsg(std::string_view content) = 0;
+
+    /**
+     * @brief Builds an AUTH message.
+     */
+    virtual void buildAuthMsg(std::string_view username, std::string_view secret) = 0;
+
+    /**
+     * @brief Builds a JOIN message.
+     */
+    virtual void buildJoinMsg(std::string_view channel_id) = 0;
+
+    /**
+     * @brief Builds a MSG message.
+     */
+    virtual void buildMsgMsg(std::string_view user_msg) = 0;
+
+    /**
+     * @brief Handles one valid user command or message that has to be sent to the server.
+     * @param user_input Parsed user input.
+     */
+    virtual void processUserInput(const User_input& user_input) = 0;
+
+    /**
+     * @brief Handles the end of user input.
+     */
+    virtual void processEof() = 0;
+
+    /**
+     * @brief Handles SIGINT.
+     */
+    virtual void processInterrupt() = 0;
+
+    /**
+     * @brief Handles a failure of the transport.
+     * @param reason Description of the failure.
+     */
+    virtual void processTransportFailure(const char* reason) = 0;
+
+    /**
+     * @brief Processes the expiration of a named timer.
+     * @param name Name the timer was started with.
+     */
+    virtual void processTimerEvent(Timer_name name) = 0;
+
+    /**
+     * @brief Handles non-MSG user commands.
+     * @param user_input Parsed user input.
+     * @return True if handled successfully, false otherwise.
+     */
+    bool processNonMsgToServer(const User_input& user_input);
+
+    /**
+     * @brief Parses one line of user input and checks that it can be processed in the current state.
+     * @param line The line without LF.
+     * @return Parsed input with views into line, of type U_INVALID if an error has been reported.
+     */
+    User_input parseUserInput(std::string_view line);
+
+    /**
+     * @brief Checks if the client can currently send a message of the given type.
+     */
+    bool canSendMessageType(Protocol_msg_type msg_type) const;
+
+    /**
+     * @brief Requests delivering a message received from the server.
+     * @param msg_type Type of the message (MSG, REPLY or ERR).
+     * @param display_name Sender of MSG or ERR.
+     * @param content Content of the message.
+     * @param is_positive True for a positive REPLY.
+     */
+    void addReceiveAction(Protocol_msg_type msg_type, std::string_view display_name, std::string_view content,
+                          bool is_positive);
+
+    /// @return A new action of the given type appended to the actions of the current call.
+    Protocol_action& addAction(Action_type type);
+
+    Action_list m_actions{};                                              ///< Actions of the current call (capacity is reused).
+    Clock::time_point m_now;                                              ///< Time passed to the current call.
+    bool m_is_closed{false};                                              ///< True once A_CLOSE has been returned.
+    Timer_wheel m_timer_wheel;                                            ///< All deadlines the session is waiting for.
+    std::vector<Timer_name> m_expired_timers{};                           ///< Names of timers expired at the last processTimers().
+    std::optional<Clock::time_point> m_reported_deadline{};               ///< Deadline reported by the last A_SET_TIMER.
+};
+
+#endif // PROTOCOL_SESSION_H
@@ -0,0 +1,56 @@
+/**
+ * @file replay-window.h
+ * @author Andrii Klymenko
+ * @brief Sliding window of recently received server MessageIDs used to suppress duplicate UDP messages.
+ */
+
+#ifndef REPLAY_WINDOW_H
+#define REPLAY_WINDOW_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class Replay_window
+ * @brief Remembers which of the last s_WINDOW_SIZE MessageIDs (up to the highest one received) have been seen.
+ *
+ * MessageIDs are compared using serial number arithmetic, so the window keeps sliding correctly after the 16-bit
+ * MessageID wraps around. Bit of MessageID i is stored at position i % s_WINDOW_SIZE.
+ */
+class Replay_window {
+public:
+    /// Number of MessageIDs the window remembers.
+    static constexpr uint16_t s_WINDOW_SIZE{1024};
+
+    /**
+     * @brief Checks if a message has already been received.
+     * @param msg_id MessageID of the message.
+     * @return True if the MessageID is in the window and has been marked as seen. MessageIDs older than the window
+     * are reported as not seen, because the server retransmits a message only until it is confirmed.
+     */
+    bool contains(uint16_t msg_id) const;
+
+    /**
+     * @brief Marks a message as received, sliding the window forward if the MessageID is newer than all previous ones.
+     * @param msg_id MessageID of the message.
+     */
+    void insert(uint16_t msg_id);
+
+private:
+    static constexpr uint16_t s_BITS_IN_WORD{64}; ///< Number of bits in one word of the bitmap.
+
+    std::array<uint64_t, s_WINDOW_SIZE / s_BITS_IN_WORD> m_seen{}; ///< Bitmap of the seen MessageIDs.
+    uint16_t m_highest_msg_id{0};                                 ///< Highest MessageID received so far.
+    bool m_is_empty{true};                                        ///< True until the first MessageID is inserted.
+
+    /// @return Distance of the MessageID behind the highest one (negative if it is newer).
+    int32_t getAge(uint16_t msg_id) const;
+
+    /// @brief Marks the bit of the MessageID as seen.
+    void setBit(uint16_t msg_id);
+
+    /// @brief Marks the bit of the MessageID as not seen.
+    void clearBit(uint16_t msg_id);
+};
+
+#endif // REPLAY_WINDOW_H
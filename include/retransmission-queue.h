@@ -0,0 +1,94 @@
+/**
+ * @file retransmission-queue.h
+ * @author Andrii Klymenko
+ * @brief Queue of client messages sent over UDP and not yet confirmed by the server.
+ */
+
+#ifndef RETRANSMISSION_QUEUE_H
+#define RETRANSMISSION_QUEUE_H
+
+#include "protocol-msg-type.h"
+#include "timer-wheel.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Client message waiting for a CONFIRM from the server.
+ */
+struct Pending_msg {
+    std::string msg{};                                           ///< Message bytes used for retransmission.
+    uint16_t msg_id{};                                           ///< MessageID of the message.
+    Protocol_msg_type type{Protocol_msg_type::M_UNKNOWN};        ///< Type of the message.
+    Timer_wheel::Timer_handle timer{Timer_wheel::s_INVALID_HANDLE}; ///< Timer of the retransmission.
+    std::chrono::steady_clock::time_point sent_at{};             ///< When the message was sent for the first time.
+    uint8_t retransmissions_left{};                              ///< Number of retransmissions still allowed.
+};
+
+/**
+ * @class Retransmission_queue
+ * @brief Sliding window of at most window_size unconfirmed client messages keyed by their MessageID.
+ *
+ * Entries may be retired in any order, as CONFIRM messages arrive. The slots are allocated once and reused, a retired
+ * slot is swapped behind the live ones, so its message buffer keeps its capacity for the next push().
+ */
+class Retransmission_queue {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     * @param window_size Maximal number of unconfirmed messages.
+     */
+    explicit Retransmission_queue(std::size_t window_size);
+
+    /// @return True if no more messages may be sent before some are confirmed.
+    bool isFull() const;
+
+    /// @return True if all sent messages have been confirmed.
+    bool isEmpty() const;
+
+    /// @return Number of unconfirmed messages.
+    std::size_t getSize() const;
+
+    /**
+     * @brief Adds a slot for a sent message to the queue; the queue must not be full.
+     * @return The slot to be filled in; its fields hold stale values of a previously retired message.
+     */
+    Pending_msg& push();
+
+    /**
+     * @brief Removes a confirmed message from the queue.
+     * @param msg_id MessageID the CONFIRM refers to.
+     * @return The removed message (valid until the next push()), or nullptr if no such message is waiting for
+     * a CONFIRM (e.g. a duplicate CONFIRM).
+     */
+    const Pending_msg* retire(uint16_t msg_id);
+
+    /**
+     * @brief Checks if a message is still waiting for its CONFIRM.
+     * @param msg_id MessageID of the message.
+     */
+    bool contains(uint16_t msg_id) const;
+
+    /**
+     * @brief Finds a message waiting for its CONFIRM.
+     * @param msg_id MessageID of the message.
+     * @return Pointer to the message (valid until the queue is modified), or nullptr if there is no such message.
+     */
+    Pending_msg* find(uint16_t msg_id);
+
+    /**
+     * @brief Drops all unconfirmed messages.
+     */
+    void clear();
+
+    /// Iteration over the unconfirmed messages (used to stop their timers).
+    std::vector<Pending_msg>::iterator begin();
+    std::vector<Pending_msg>::iterator end();
+
+private:
+    std::vector<Pending_msg> m_pending_msgs;   ///< Slots; the first m_size of them hold unconfirmed messages.
+    std::size_t m_size{0};                     ///< Number of unconfirmed messages.
+};
+
+#endif // RETRANSMISSION_QUEUE_H
@@ -0,0 +1,62 @@
+/**
+ * @file rtt-estimator.h
+ * @author Andrii Klymenko
+ * @brief Retransmission timeout computed from measured round-trip times (RFC 6298).
+ */
+
+#ifndef RTT_ESTIMATOR_H
+#define RTT_ESTIMATOR_H
+
+#include <chrono>
+#include <optional>
+
+/**
+ * @class Rtt_estimator
+ * @brief Keeps the smoothed round-trip time (SRTT) and its variation (RTTVAR) and derives the retransmission timeout (RTO).
+ *
+ * RTO = SRTT + max(G, 4 * RTTVAR), where G is the granularity of the client's timers. The RTO is doubled by every
+ * retransmission (exponential backoff) and always stays within the configured bounds.
+ */
+class Rtt_estimator {
+public:
+    /**
+     * @brief Constructs an estimator without any measurement.
+     * @param initial_rto RTO used until the first round-trip time is measured.
+     * @param min_rto Lower bound of the RTO.
+     * @param max_rto Upper bound of the RTO.
+     */
+    Rtt_estimator(std::chrono::milliseconds initial_rto, std::chrono::milliseconds min_rto,
+                  std::chrono::milliseconds max_rto);
+
+    /**
+     * @brief Updates SRTT, RTTVAR and RTO with a new measurement.
+     * @param rtt Time between sending a message and receiving its CONFIRM. Retransmitted messages must not be measured
+     * (Karn's algorithm), as it isn't known which of the copies was confirmed.
+     */
+    void addSample(std::chrono::steady_clock::duration rtt);
+
+    /**
+     * @brief Doubles the RTO after a retransmission.
+     */
+    void backOff();
+
+    /// @return Current retransmission timeout, rounded up to milliseconds.
+    std::chrono::milliseconds getRto() const;
+
+private:
+    using Microseconds = std::chrono::microseconds;
+
+    /// Granularity of the timers the RTO is used with (see Timer_wheel).
+    static constexpr Microseconds s_CLOCK_GRANULARITY{1000};
+
+    std::optional<Microseconds> m_srtt{}; ///< Smoothed round-trip time, nothing before the first measurement.
+    Microseconds m_rttvar{};              ///< Round-trip time variation.
+    Microseconds m_rto;                   ///< Current retransmission timeout.
+    Microseconds m_min_rto;               ///< Lower bound of the RTO.
+    Microseconds m_max_rto;               ///< Upper bound of the RTO.
+
+    /// @brief Keeps the RTO within its bounds.
+    void clampRto();
+};
+
+#endif // RTT_ESTIMATOR_H
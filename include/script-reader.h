@@ -0,0 +1,87 @@
+/**
+ * @file script-reader.h
+ * @author Andrii Klymenko
+ * @brief Scripted user input of a session of the load generator.
+ */
+
+#ifndef SCRIPT_READER_H
+#define SCRIPT_READER_H
+
+#include "input-source.h"
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class Script_reader
+ * @brief Hands out the lines of a script shared by all sessions, paced by a think time and a chat message rate.
+ *
+ * Every "{session}" in a line is replaced by the number of the session, so each session can authenticate as
+ * a different user. The pause before a line starts when the session asks for it, i.e. after the previous command has
+ * been completed (e.g. after the REPLY to AUTH), and the end of the script is delayed the same way, so the last
+ * messages are confirmed before BYE is sent.
+ */
+class Script_reader : public Input_source {
+public:
+    /**
+     * @brief Constructs a reader positioned at the first line.
+     * @param script Lines of the script (without LF).
+     * @param session_number Number substituted for "{session}".
+     * @param think_time Pause before every line and before the end of the script.
+     * @param msg_interval Minimal time between two chat messages (zero for no limit).
+     */
+    Script_reader(std::shared_ptr<const std::vector<std::string>> script, unsigned session_number,
+                  std::chrono::milliseconds think_time, std::chrono::microseconds msg_interval);
+
+    /// @return -1, the whole script is available without reading.
+    int getFileDescriptor() const override;
+
+    /**
+     * @brief Does nothing.
+     * @return True.
+     */
+    bool read() override;
+
+    /**
+     * @brief Extracts the next line once its pause has elapsed.
+     * @param line Set to a view of the line with substituted placeholders; valid until the next call.
+     */
+    Line_status nextLine(std::string_view& line) override;
+
+    /// @return False.
+    bool isFull() const override;
+
+    /// @return True.
+    bool isEofRead() const override;
+
+    /// @return True once the pause after the last line has elapsed.
+    bool isEof() const override;
+
+    /// @return End of the current pause, or nothing if the next line hasn't been asked for yet.
+    std::optional<Clock::time_point> getNextLineTime() const override;
+
+private:
+    /// Placeholder replaced by the number of the session.
+    static constexpr std::string_view s_SESSION_PLACEHOLDER{"{session}"};
+
+    /**
+     * @brief Stores a script line with substituted placeholders to m_line.
+     * @param script_line Line of the script.
+     */
+    void substitute(const std::string& script_line);
+
+    std::shared_ptr<const std::vector<std::string>> m_script; ///< Lines of the script.
+    std::string m_session_number;                           ///< Number substituted for the placeholder.
+    std::chrono::milliseconds m_think_time;                 ///< Pause before every line.
+    std::chrono::microseconds m_msg_interval;               ///< Minimal time between two chat messages.
+    std::size_t m_next_line{0};                             ///< Index of the next line of the script.
+    std::string m_line{};                                   ///< Last extracted line.
+    std::optional<Clock::time_point> m_next_line_time{};     ///< End of the current pause.
+    std::optional<Clock::time_point> m_last_msg_time{};      ///< When the last chat message was extracted.
+    bool m_is_eof{false};                                   ///< True once the end of the script has been reached.
+};
+
+#endif // SCRIPT_READER_H
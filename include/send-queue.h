@@ -0,0 +1,63 @@
+/**
+ * @file send-queue.h
+ * @author Andrii Klymenko
+ * @brief Outbound byte queue of a non-blocking stream socket.
+ */
+
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+#include <cstddef>
+#include <string>
+#include <sys/uio.h> // struct iovec
+
+/**
+ * @class Send_queue
+ * @brief Sends messages to a non-blocking stream socket and keeps the bytes the socket doesn't accept at once.
+ *
+ * A message is sent directly from its parts while the queue is empty; only the unsent rest of it is copied to the queue,
+ * which is sent by flush() once the socket becomes writable (EPOLLOUT). Messages are never reordered nor truncated.
+ * A failure of sending, including a connection reset by the server (reported by errno instead of raising SIGPIPE thanks
+ * to MSG_NOSIGNAL), is returned to the caller, so it terminates only the session using the socket.
+ */
+class Send_queue {
+public:
+    /**
+     * @brief Sends a message gathered from its parts or queues it behind the data already waiting.
+     * @param socket Non-blocking stream socket to send to.
+     * @param iovecs Parts of the message.
+     * @param iovec_count Number of the parts.
+     * @return False if sending has failed, e.g. errno is EPIPE if the server has closed the connection (nothing is
+     *         queued then).
+     */
+    bool send(int socket, struct iovec* iovecs, std::size_t iovec_count);
+
+    /**
+     * @brief Sends queued data until the socket would block or the queue is empty.
+     * @param socket Socket to send to.
+     * @return False if sending has failed (errno describes the failure).
+     */
+    bool flush(int socket);
+
+    /// @return True if no data is waiting to be sent.
+    bool isEmpty() const;
+
+    /// @return Number of bytes waiting to be sent.
+    std::size_t getSize() const;
+
+private:
+    /**
+     * @brief Sends as much of the given parts as the socket accepts.
+     * @param socket Socket to send to.
+     * @param iovecs Parts to send.
+     * @param iovec_count Number of the parts.
+     * @param sent_bytes Set to the number of sent bytes (0 if the socket would block).
+     * @return False if sending has failed (errno describes the failure).
+     */
+    static bool sendParts(int socket, struct iovec* iovecs, std::size_t iovec_count, std::size_t& sent_bytes);
+
+    std::string m_data{};    ///< Queued bytes; the first m_begin of them have already been sent.
+    std::size_t m_begin{0};  ///< Start of the unsent data.
+};
+
+#endif // SEND_QUEUE_H
@@ -0,0 +1,59 @@
+/**
+ * @file session-outcome.h
+ * @author Andrii Klymenko
+ * @brief Result of processing an event of a client session.
+ */
+
+#ifndef SESSION_OUTCOME_H
+#define SESSION_OUTCOME_H
+
+#include <string_view>
+
+/**
+ * @brief Whether a client session keeps running after an event.
+ */
+enum class Outcome_type
+{
+    O_CONTINUE, ///< The session keeps running.
+    O_SUCCESS,  ///< The session has terminated without an error (BYE, SIGINT, end of input).
+    O_FAILURE,  ///< The session has terminated with an error.
+};
+
+/**
+ * @brief Outcome of a handler of a client session, returned up to Event_loop, which terminates the session unless it
+ * continues. The normal termination of a session isn't an exception, so it doesn't unwind the stack of the shared loop.
+ */
+struct Session_outcome {
+    Outcome_type type{Outcome_type::O_CONTINUE}; ///< Whether the session keeps running.
+    std::string_view reason{};                   ///< O_FAILURE: error to be reported (empty if it has been reported already);
+                                                 ///< refers to a literal or to the session, so it is valid while the session exists.
+
+    /// @return The session keeps running.
+    static constexpr Session_outcome proceed()
+    {
+        return {};
+    }
+
+    /// @return The session has terminated without an error.
+    static constexpr Session_outcome succeed()
+    {
+        return {Outcome_type::O_SUCCESS, {}};
+    }
+
+    /**
+     * @param reason Error to be reported (empty if it has been reported already).
+     * @return The session has terminated with the error.
+     */
+    static constexpr Session_outcome fail(std::string_view reason)
+    {
+        return {Outcome_type::O_FAILURE, reason};
+    }
+
+    /// @return True if the session has terminated (with success or failure).
+    constexpr bool isFinished() const
+    {
+        return type != Outcome_type::O_CONTINUE;
+    }
+};
+
+#endif // SESSION_OUTCOME_H
@@ -0,0 +1,86 @@
+/**
+ * @file session-stats.h
+ * @author Andrii Klymenko
+ * @brief Counters of the traffic of client sessions.
+ */
+
+#ifndef SESSION_STATS_H
+#define SESSION_STATS_H
+
+#include <cstdint>
+
+/**
+ * @brief Traffic of one client session.
+ */
+struct Session_stats {
+    uint64_t sent_msg_count{0};       ///< AUTH, JOIN and MSG messages sent on behalf of the user.
+    uint64_t received_msg_count{0};   ///< MSG messages received from the server.
+    uint64_t positive_reply_count{0}; ///< Positive REPLY messages received from the server.
+    uint64_t negative_reply_count{0}; ///< Negative REPLY messages received from the server.
+    uint64_t received_err_count{0};   ///< ERR messages received from the server.
+
+    /**
+     * @brief Adds the counters of another session.
+     * @param other Counters to add.
+     */
+    Session_stats& operator+=(const Session_stats& other)
+    {
+        sent_msg_count += other.sent_msg_count;
+        received_msg_count += other.received_msg_count;
+        positive_reply_count += other.positive_reply_count;
+        negative_reply_count += other.negative_reply_count;
+        received_err_count += other.received_err_count;
+        return *this;
+    }
+};
+
+/**
+ * @brief Batching of the datagrams received by UDP sessions (datagrams per wakeup = datagram_count / wakeup_count).
+ */
+struct Receive_stats {
+    uint64_t wakeup_count{0};             ///< Number of processed socket events.
+    uint64_t datagram_count{0};           ///< Number of received datagrams.
+    uint64_t max_datagrams_per_wakeup{0}; ///< Largest number of datagrams received during one socket event.
+
+    /**
+     * @brief Adds the counters of another session.
+     * @param other Counters to add.
+     */
+    Receive_stats& operator+=(const Receive_stats& other)
+    {
+        wakeup_count += other.wakeup_count;
+        datagram_count += other.datagram_count;
+
+        if(other.max_datagrams_per_wakeup > max_datagrams_per_wakeup)
+        {
+            max_datagrams_per_wakeup = other.max_datagrams_per_wakeup;
+        }
+
+        return *this;
+    }
+};
+
+/**
+ * @brief Totals of the finished sessions of an event loop.
+ */
+struct Loop_stats {
+    uint64_t succeeded_session_count{0}; ///< Sessions terminated with success (BYE, end of input, SIGINT).
+    uint64_t failed_session_count{0};    ///< Sessions terminated with an error.
+    Session_stats session_totals{};      ///< Sum of the traffic of all finished sessions.
+    Receive_stats receive_totals{};      ///< Receive batching of all finished UDP sessions.
+
+    /**
+     * @brief Adds the totals of another event loop.
+     * @param other Totals to add.
+     */
+    Loop_stats& operator+=(const Loop_stats& other)
+    {
+        succeeded_session_count += other.succeeded_session_count;
+        failed_session_count += other.failed_session_count;
+        session_totals += other.session_totals;
+        receive_totals += other.receive_totals;
+        return *this;
+    }
+};
+
+#endif // SESSION_STATS_H
@@ -0,0 +1,87 @@
+/**
+ * @file sharded-executor.h
+ * @author Andrii Klymenko
+ * @brief Runs client sessions on one event loop per CPU.
+ */
+
+#ifndef SHARDED_EXECUTOR_H
+#define SHARDED_EXECUTOR_H
+
+#include "event-loop.h"
+#include "session-stats.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Client;
+
+/**
+ * @class Sharded_executor
+ * @brief Spreads sessions over worker threads, each pinned to one CPU and running its own Event_loop.
+ *
+ * A session is assigned to a loop by the hash of its number, constructed by the worker thread of that loop and never
+ * leaves it, so Tcp_client and Udp_client are still used by a single thread and need no locking. Every loop counts its
+ * own statistics; they are summed once all workers have been joined. The calling thread receives SIGINT and passes it
+ * to every loop.
+ */
+class Sharded_executor {
+public:
+    /// Creates session number n on the given loop; called by the worker thread of the loop.
+    using Session_factory = std::function<std::unique_ptr<Client>(Event_loop& event_loop, uint32_t session_number)>;
+
+    /**
+     * @brief Constructs an executor with one loop per CPU the process may run on, but not more loops than sessions.
+     * @param session_count Number of sessions to be run.
+     */
+    explicit Sharded_executor(uint32_t session_count);
+
+    /**
+     * @brief Runs all sessions until they terminate.
+     * @param create_session Creates a session on a loop.
+     * @return Totals of all loops.
+     */
+    Loop_stats run(const Session_factory& create_session);
+
+    /// @return Number of loops (worker threads).
+    std::size_t getLoopCount() const;
+
+private:
+    /**
+     * @brief A worker thread with its loop; only the worker touches the loop except interrupt().
+     */
+    struct Shard {
+        int cpu{-1};                        ///< CPU the worker is pinned to.
+        std::unique_ptr<Event_loop> loop{}; ///< Loop of the worker.
+        Loop_stats stats{};                 ///< Totals of the loop, read only after the worker has been joined.
+    };
+
+    /**
+     * @brief Body of a worker thread: pins it, creates the sessions of its shard and runs the loop.
+     * @param shard_index Index of the shard.
+     * @param create_session Creates a session on the loop.
+     * @param done_fd Eventfd signalled when the loop has finished.
+     */
+    void runShard(std::size_t shard_index, const Session_factory& create_session, int done_fd);
+
+    /**
+     * @brief Waits until every worker has signalled its completion and passes SIGINT to all loops meanwhile.
+     * @param signal_fd Signalfd receiving SIGINT.
+     * @param done_fd Eventfd signalled by the workers.
+     */
+    void waitForShards(int signal_fd, int done_fd);
+
+    /**
+     * @brief Gets the CPUs the process may run on.
+     * @return Numbers of the CPUs (at least one, 0 if the affinity mask can't be read).
+     */
+    static std::vector<int> getAllowedCpus();
+
+    /// @return Index of the shard running the given session.
+    std::size_t getShardIndex(uint32_t session_number) const;
+
+    uint32_t m_session_count;      ///< Number of sessions to be run.
+    std::vector<Shard> m_shards{}; ///< One shard per loop.
+};
+
+#endif // SHARDED_EXECUTOR_H
@@ -0,0 +1,19 @@
+/**
+ * @file socket-address.h
+ * @author Andrii Klymenko
+ * @brief Utility functions for IPv4 and IPv6 socket addresses.
+ */
+
+#ifndef SOCKET_ADDRESS_H
+#define SOCKET_ADDRESS_H
+
+#include <sys/socket.h> // struct sockaddr_storage, socklen_t
+
+/**
+ * @brief Gets the length of the address stored in the structure (as expected by connect(), sendto(), ...).
+ * @param address IPv4 or IPv6 socket address.
+ * @return Size of sockaddr_in or sockaddr_in6 according to the address family.
+ */
+socklen_t getSocketAddressLength(const struct sockaddr_storage& address);
+
+#endif // SOCKET_ADDRESS_H
@@ -0,0 +1,77 @@
+/**
+ * @file stdin-reader.h
+ * @author Andrii Klymenko
+ * @brief Non-blocking reader splitting the standard input into lines.
+ */
+
+#ifndef STDIN_READER_H
+#define STDIN_READER_H
+
+#include "input-source.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/**
+ * @class Stdin_reader
+ * @brief Reads all available user input at once and queues it in a fixed-capacity buffer until its lines are processed.
+ *
+ * Standard input is switched to non-blocking mode for the lifetime of the reader. Lines are handed out as views into
+ * the buffer, so the queue costs no allocations; the unprocessed part is moved to the front by the next read().
+ * A line that doesn't fit into the buffer is skipped.
+ */
+class Stdin_reader : public Input_source {
+public:
+    /**
+     * @brief Switches stdin to non-blocking mode.
+     * @param capacity Number of bytes the buffer can hold (limits the length of a line).
+     */
+    explicit Stdin_reader(std::size_t capacity);
+
+    /**
+     * @brief Restores the original mode of stdin.
+     */
+    ~Stdin_reader() override;
+
+    Stdin_reader(const Stdin_reader&) = delete;
+    Stdin_reader& operator=(const Stdin_reader&) = delete;
+
+    /// @return STDIN_FILENO.
+    int getFileDescriptor() const override;
+
+    /**
+     * @brief Reads available input until stdin would block, the buffer is full or the end of input is reached.
+     *
+     * Invalidates all lines extracted so far.
+     * @return False if read() has failed.
+     */
+    bool read() override;
+
+    /**
+     * @brief Extracts the next line (without LF). The last line doesn't need to be terminated by LF.
+     * @param line Set to a view of the line; valid until the next call of read().
+     */
+    Line_status nextLine(std::string_view& line) override;
+
+    /// @return True if no more input can be buffered until some lines are extracted.
+    bool isFull() const override;
+
+    /// @return True if the end of input has been read.
+    bool isEofRead() const override;
+
+    /// @return True if the end of input has been read and all lines have been extracted.
+    bool isEof() const override;
+
+private:
+    std::unique_ptr<char[]> m_data;    ///< Storage.
+    std::size_t m_capacity;            ///< Size of the storage.
+    std::size_t m_begin{0};            ///< Start of the first not extracted byte.
+    std::size_t m_end{0};              ///< End of the read data.
+    std::size_t m_scan{0};             ///< Position from which LF hasn't been searched for yet.
+    bool m_is_eof_read{false};         ///< True once read() has returned 0.
+    bool m_is_discarding{false};       ///< True while skipping the rest of a too long line.
+    int m_original_flags;              ///< File status flags of stdin before switching to non-blocking mode.
+};
+
+#endif // STDIN_READER_H
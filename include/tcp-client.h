@@ -8,159 +8,129 @@
 #define TCP_CLIENT_H
 
 #include "client.h"
-#include <cstring>
+#include "tcp-session.h"
+#include "send-queue.h"
+#include "tcp-connector.h"
 
 /**
  * @brief Represents a TCP-based chat client implementing the IPK25-CHAT protocol.
  *
- * This class handles building and sending protocol messages over a TCP socket, processing
- * server responses, and managing input/output events.
+ * This class connects to the server, passes the received bytes to its Tcp_session and sends the messages the session
+ * builds, queueing the part the socket doesn't accept at once.
  */
 class Tcp_client : public Client {
 public:
     /**
      * @brief Constructs a TCP client with the given command-line arguments.
      * @param args Command-line arguments specifying configuration such as address and port.
+     * @param event_loop Loop dispatching the events of the session.
+     * @param input_source User input of the session.
+     * @param callbacks Receivers of the output of the session.
      */
-    Tcp_client(const Args& args);
-
-    /**
-     * @brief Sends a BYE message to the server and terminates a connection
-     */
-    void sendByeMsgToServer() override;
-
-    static constexpr const char* s_END_OF_MESSAGE{"\r\n"};
-    static constexpr std::size_t s_BYTES_IN_END_OF_MESSAGE{2};
-
-    /// @brief Maximum message size for outgoing incoming/outgoing messages
-    static constexpr int s_MAX_MSG_SIZE{static_cast<int> (strlen("MSG FROM")) + static_cast<int> (strlen(" ")) +
-        s_DISPLAY_NAME_MAX_LENGTH + static_cast<int> (strlen(" IS ")) + s_MSG_CONTENT_MAX_LENGTH + static_cast<int> (s_BYTES_IN_END_OF_MESSAGE)};
+    Tcp_client(const Args& args, Event_loop& event_loop, std::shared_ptr<Input_source> input_source,
+               Chat_callbacks callbacks);
 
 private:
-    /**
-     * @brief Builds and stores an error message to send to the server.
-     * @param content Content of the error message.
-     */
-    void buildErrMsg(std::string content) override;
+    /// @return Protocol core of the session.
+    Protocol_session& getSession() override;
 
     /**
-     * @brief Builds an AUTH message using user's username and his secret.
-     * @param username user's username.
-     * @param secret user's secret.
+     * @brief Sends a message to the server, queueing the part the socket doesn't accept at once.
+     * @param msg The message.
      */
-    void buildAuthMsg(const std::string& username, const std::string& secret) override;
+    void sendMsgToServer(Outbound_msg& msg) override;
 
     /**
-     * @brief Builds a JOIN message using channel id.
-     * @param channel_id id of the channel the user wants to join.
+     * @brief Lets the loop send the queued messages before the client terminates: the socket is watched only for
+     * EPOLLOUT and the session terminates once the queue is empty or the deadline of sending expires.
+     * @return True if nothing is queued.
      */
-    void buildJoinMsg(const std::string& channel_id) override;
+    bool finishSending() override;
 
-    /**
-     * @brief Builds a MSG message from user input.
-    * @param user_msg user's message.
-     */
-    void buildMsgMsg(const std::string& user_msg) override;
+    /// @return True once the connection to the server has been established.
+    bool isConnected() const;
 
     /**
-     * @brief Builds a BYE message for clean disconnection.
+     * @brief Starts the first connection attempt once the server hostname has been resolved.
+     * @return Whether the session keeps running.
      */
-    void buildByeMsg() override;
+    Session_outcome processServerAddrsResolved() override;
 
     /**
-     * @brief Sends the built message to the server.
+     * @brief Starts the next connection attempt and schedules the one after it.
+     * @return Whether the session keeps running (it fails once no attempt is left).
      */
-    void sendMsgToServer() override;
+    Session_outcome startNextConnectionAttempt();
 
     /**
-     * @brief Sends an error message and terminates the client.
-     * @param err_msg The message to display before terminating.
+     * @brief Processes the completion of a connection attempt; the first successful attempt becomes the client socket.
+     * @param socket Socket of the attempt.
+     * @param events Ready event flags of the socket.
+     * @return Whether the session keeps running.
      */
-    void sendErrMsgAndTerminate(const char* err_msg);
+    Session_outcome processConnectEvent(int socket, uint32_t events) override;
 
     /**
-     * @brief Handles a timeout event from the timer file descriptor.
+     * @brief Registers the socket for EPOLLOUT while there are queued messages to the server.
      */
-    void processTimerEvent() override;
+    void updateSocketEvents();
 
     /**
-     * @brief Processes a read event on the socket file descriptor.
-     * @return uint8_t 0 if EXIT_SUCCESS needs to be returned in main(), 1 if EXIT_FAILURE needs to be returned in main(),
-     * 2 if client's loop needs to be continued
+     * @brief Records a failure of the send queue (described by errno) by setSendError().
      */
-    uint8_t processSocketEvent() override;
+    void setSendQueueError();
 
     /**
-     * @brief Processes a read event on standard input (user input).
+     * @brief Blocks user input while the session waits for a REPLY or while the send queue is above its high-water mark.
      */
-    void processStdinEvent() override;
+    bool isUserInputEnabled() override;
 
     /**
-     * @brief Handles SIGINT (Ctrl+C) by sending BYE message and successfully terminating.
+     * @brief Handles the expiration of the timers of the connection attempts.
+     * @param name Name of the expired timer.
+     * @return Whether the session keeps running (it fails once the connection deadline expires).
      */
-    void sigintHandler() override;
+    Session_outcome processTimerEvent(Timer_name name) override;
 
     /**
-     * @brief Processes a server BYE message.
-     * @param bye_msg_from_server The full BYE server message string.
+     * @brief Processes a read event on the socket file descriptor.
+     * @param events Ready event flags of the socket.
+     * @return Whether the session keeps running.
      */
-    void processServerByeMsg(const std::string& bye_msg_from_server);
+    Session_outcome processSocketEvent(uint32_t events) override;
 
-    /**
-     * @brief Processes a server ERR message.
-     * @param err_msg_from_server The full ERR server message string.
-     */
-    void processServerErrMsg(const std::string& err_msg_from_server);
+    /// @brief Protocol core of the session.
+    Tcp_session m_session;
 
-    /**
-     * @brief Processes a server MSG message.
-     * @param msg_msg_from_server The full MSG server message string.
-     */
-    void processServerMsgMsg(const std::string& msg_msg_from_server);
+    /// @brief Size of the send queue above which user input is paused until the server catches up.
+    static constexpr std::size_t s_SEND_QUEUE_HIGH_WATER_MARK{2 * Tcp_session::s_MAX_MSG_SIZE};
 
-    /**
-     * @brief Processes a server MSG message.
-     * @param msg_msg_from_server The full MSG server message string.
-     */
-    void processServerReplyMsg(const std::string& reply_msg_from_server);
+    /// @brief Maximal time to send the queued messages before terminating.
+    static constexpr std::chrono::milliseconds s_MAX_DRAIN_TIME{std::chrono::seconds{Protocol_session::s_MAX_REPLY_WAIT_TIME}};
 
-    /**
-     * @brief Processes an incoming server message.
-     * @param msg_from_server The full message received from the server.
-     * @return uint8_t 0 if EXIT_SUCCESS needs to be returned from main(), 1 if EXIT_FAILURE needs to be returned from main(),
-     * 2 if client's loop needs to be continued
-     */
-    uint8_t processMessageFromServer(const std::string& msg_from_server);
+    /// @brief Error of a message that couldn't be sent because the server has closed the connection.
+    static constexpr const char* s_CONNECTION_CLOSED_ERROR{"couldn't send a message to the server: the connection has been closed."};
 
-    /**
-     * @brief Extracts the protocol message type from a server message.
-     * @param msg_from_server The message received from the server.
-     * @return The detected protocol message type.
-     */
-    Protocol_msg_type getServerMsgType(const std::string& msg_from_server) const;
+    /// @brief Error of a message that couldn't be sent for any other reason.
+    static constexpr const char* s_SEND_ERROR{"couldn't send a message to the server: sendmsg() has failed."};
 
-    /**
-     * @brief Gets the regex used to match REPLY messages.
-     */
-    static const std::regex& getReplyMsgRegex();
+    /// @brief Delay between starting two connection attempts (Connection Attempt Delay recommended by RFC 8305).
+    static constexpr std::chrono::milliseconds s_CONNECTION_ATTEMPT_DELAY{250};
 
-    /**
-     * @brief Gets the regex used to match MSG messages.
-     */
-    static const std::regex& getMsgMsgRegex();
+    /// @brief Pending connection attempts.
+    Tcp_connector m_connector;
 
-    /**
-     * @brief Gets the regex used to match ERR messages.
-     */
-    static const std::regex& getErrMsgRegex();
+    /// @brief Timer starting the next connection attempt.
+    Timer_wheel::Timer_handle m_connect_attempt_timer{Timer_wheel::s_INVALID_HANDLE};
 
-    /**
-     * @brief Gets the regex used to match BYE messages.
-     */
-    static const std::regex& getByeMsgRegex();
+    /// @brief Timer limiting the establishment of the connection.
+    Timer_wheel::Timer_handle m_connect_deadline_timer{Timer_wheel::s_INVALID_HANDLE};
+
+    /// @brief Messages to the server the socket hasn't accepted yet.
+    Send_queue m_send_queue{};
 
-    /// @brief Internal buffer for a message received from the server.
-    std::string m_msg_from_server{};
+    /// @brief True if the socket is registered for EPOLLOUT.
+    bool m_is_socket_output_registered{false};
 };
 
 #endif // TCP_CLIENT_H
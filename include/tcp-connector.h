@@ -0,0 +1,95 @@
+/**
+ * @file tcp-connector.h
+ * @author Andrii Klymenko
+ * @brief Non-blocking establishment of the TCP connection racing all server addresses.
+ */
+
+#ifndef TCP_CONNECTOR_H
+#define TCP_CONNECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h> // struct sockaddr_storage
+#include <vector>
+
+class Client;
+class Event_loop;
+
+/**
+ * @class Tcp_connector
+ * @brief Connection attempts to the server addresses in the style of Happy Eyeballs (RFC 8305).
+ *
+ * IPv6 and IPv4 addresses are interleaved, starting with the family of the first one. Each attempt is a non-blocking
+ * connect() registered in the client's event loop for EPOLLOUT. The client starts
+ * the first attempt at once and each next one when a delay expires or when all pending attempts have failed, so a dead
+ * address costs only the delay instead of the whole SYN timeout. The first attempt that succeeds wins, the others are closed.
+ */
+class Tcp_connector {
+public:
+    /**
+     * @brief Constructs a connector without any addresses and attempts.
+     * @param event_loop Loop the attempts are registered in.
+     * @param owner Session the events of the attempts are passed to.
+     */
+    Tcp_connector(Event_loop& event_loop, Client& owner);
+
+    /**
+     * @brief Closes all pending attempts.
+     */
+    ~Tcp_connector();
+
+    Tcp_connector(const Tcp_connector&) = delete;
+    Tcp_connector& operator=(const Tcp_connector&) = delete;
+
+    /**
+     * @brief Sets the addresses to try once the server hostname has been resolved.
+     * @param server_addrs Addresses to try in the order of preference (as sorted by getaddrinfo()).
+     */
+    void setServerAddrs(std::vector<struct sockaddr_storage> server_addrs);
+
+    /**
+     * @brief Starts an attempt to connect to the next address; addresses that fail at once are skipped.
+     * @return False if there is no address left.
+     */
+    bool startNextAttempt();
+
+    /**
+     * @brief Processes an event of one of the pending attempts.
+     * @param socket Socket of the attempt.
+     * @param events Ready event flags of the socket.
+     * @return The connected socket, which is removed from the event loop and passed to the caller, or -1 if the attempt
+     * has failed and has been closed.
+     */
+    int processEvent(int socket, uint32_t events);
+
+    /**
+     * @brief Closes all pending attempts.
+     */
+    void closeAttempts();
+
+    /// @return True if some attempt is still in progress.
+    bool hasPendingAttempts() const;
+
+    /// @return True if some address hasn't been tried yet.
+    bool hasAddressesLeft() const;
+
+private:
+    /**
+     * @brief Reorders the addresses so that their families alternate (RFC 8305, section 4).
+     */
+    void interleaveAddressFamilies();
+
+    /**
+     * @brief Removes an attempt from the event loop and from the pending attempts.
+     * @param socket Socket of the attempt.
+     */
+    void removeAttempt(int socket);
+
+    Event_loop& m_event_loop;                       ///< Event loop of the client.
+    Client& m_owner;                                ///< Session the attempts belong to.
+    std::vector<struct sockaddr_storage> m_server_addrs; ///< Addresses to try, families interleaved.
+    std::size_t m_next_addr{0};                     ///< Index of the next address to try.
+    std::vector<int> m_attempt_sockets{};           ///< Sockets of the pending attempts.
+};
+
+#endif // TCP_CONNECTOR_H
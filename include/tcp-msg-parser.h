@@ -0,0 +1,77 @@
+/**
+ * @file tcp-msg-parser.h
+ * @author Andrii Klymenko
+ * @brief Single-pass parser of messages received by the TCP version of IPK25-CHAT client.
+ */
+
+#ifndef TCP_MSG_PARSER_H
+#define TCP_MSG_PARSER_H
+
+#include "protocol-msg-type.h"
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Result of parsing one message received from the server.
+ *
+ * All views point into the buffer the message was parsed from and are valid only as long as that buffer is.
+ */
+struct Tcp_server_msg {
+    Protocol_msg_type type{Protocol_msg_type::M_UNKNOWN}; ///< Message type deduced from its case-insensitive prefix.
+    bool is_valid{false};                                 ///< True if the whole message matches its grammar.
+    bool is_positive_reply{false};                        ///< True for "REPLY OK ..."; meaningful only for REPLY.
+    std::string_view display_name{};                      ///< Display name of MSG, ERR and BYE messages.
+    std::string_view content{};                           ///< Content of MSG, ERR and REPLY messages.
+};
+
+/**
+ * @class Tcp_msg_parser
+ * @brief Case-insensitive, allocation-free parser of the IPK25-CHAT TCP grammar.
+ *
+ * Accepts exactly the messages that the following case-insensitive regular expressions would accept:
+ * - REPLY (OK|NOK) IS ([\x20-\x7E\n]+)\r\n
+ * - MSG FROM ([!-~]+) IS ([\x20-\x7E\n]+)\r\n
+ * - ERR FROM ([!-~]+) IS ([\x20-\x7E\n]+)\r\n
+ * - BYE FROM ([!-~]+)\r\n
+ */
+class Tcp_msg_parser {
+public:
+    /**
+     * @brief Deduces the type of a message from its case-insensitive prefix.
+     * @param msg Message received from the server.
+     * @return The detected protocol message type or M_UNKNOWN.
+     */
+    static Protocol_msg_type getMsgType(std::string_view msg);
+
+    /**
+     * @brief Classifies and validates one complete message (including its "\r\n" terminator).
+     * @param msg Message received from the server.
+     * @return Parsed message with views into msg.
+     */
+    static Tcp_server_msg parse(std::string_view msg);
+
+private:
+    /**
+     * @brief Consumes a keyword (compared case-insensitively) from the beginning of the message.
+     * @param msg Rest of the message; advanced past the keyword on success.
+     * @param keyword Upper-case keyword.
+     * @return True if the message starts with the keyword.
+     */
+    static bool consumeKeyword(std::string_view& msg, std::string_view keyword);
+
+    /**
+     * @brief Consumes a non-empty run of characters of the given class from the beginning of the message.
+     * @param msg Rest of the message; advanced past the run on success.
+     * @param char_class One of the Char_class::s_* flags.
+     * @param field Set to the consumed run.
+     * @return True if at least one character was consumed.
+     */
+    static bool consumeField(std::string_view& msg, uint8_t char_class, std::string_view& field);
+
+    /**
+     * @brief Checks that exactly the message terminator is left.
+     */
+    static bool isEndOfMsg(std::string_view msg);
+};
+
+#endif // TCP_MSG_PARSER_H
@@ -0,0 +1,178 @@
+/**
+ * @file tcp-session.h
+ * @author Andrii Klymenko
+ * @brief Protocol core of the TCP version of IPK25-CHAT client.
+ */
+
+#ifndef TCP_SESSION_H
+#define TCP_SESSION_H
+
+#include "protocol-session.h"
+#include "tcp-msg-parser.h"
+#include "tcp-stream-buffer.h"
+#include <cstring>
+
+/**
+ * @class Tcp_session
+ * @brief Text-based IPK25-CHAT over a byte stream: splits the received bytes into messages and builds the messages
+ * to the server.
+ *
+ * Received bytes are stored directly into the session's buffer (getReceiveSpace() and processReceived()), so the caller
+ * doesn't need any buffer of its own. The caller is expected to deliver whole A_SEND messages in order; after A_CLOSE
+ * following an A_SEND it should wait until the message has been sent before closing the connection.
+ */
+class Tcp_session : public Protocol_session {
+public:
+    /**
+     * @brief Constructs a session in the START state.
+     * @param now Current time.
+     */
+    explicit Tcp_session(Clock::time_point now);
+
+    /**
+     * @brief Gets the free space of the receive buffer (the incomplete message received before is moved to its front).
+     * @return Pointer where the next received bytes are to be stored.
+     */
+    char* getReceiveSpace();
+
+    /// @return Number of bytes that can be stored at getReceiveSpace().
+    std::size_t getReceiveSpaceSize() const;
+
+    /**
+     * @brief Processes bytes stored at getReceiveSpace().
+     * @param length Number of the stored bytes.
+     * @param now Current time.
+     */
+    const Action_list& processReceived(std::size_t length, Clock::time_point now);
+
+    /**
+     * @brief Copies bytes to the receive buffer and processes them (for callers without a receive buffer).
+     * @param data Received bytes; longer data than getReceiveSpaceSize() is handled as a too long message.
+     * @param now Current time.
+     */
+    const Action_list& processReceived(std::string_view data, Clock::time_point now);
+
+    /**
+     * @brief Processes the end of the stream (the server has closed the connection).
+     * @param now Current time.
+     */
+    const Action_list& processStreamEnd(Clock::time_point now);
+
+    /// @return True if no REPLY is awaited.
+    bool isUserInputEnabled() const override;
+
+    static constexpr const char* s_END_OF_MESSAGE{"\r\n"};
+    static constexpr std::size_t s_BYTES_IN_END_OF_MESSAGE{2};
+
+    /// @brief Maximum message size for outgoing incoming/outgoing messages
+    static constexpr int s_MAX_MSG_SIZE{static_cast<int> (strlen("MSG FROM")) + static_cast<int> (strlen(" ")) +
+        s_DISPLAY_NAME_MAX_LENGTH + static_cast<int> (strlen(" IS ")) + s_MSG_CONTENT_MAX_LENGTH + static_cast<int> (s_BYTES_IN_END_OF_MESSAGE)};
+
+private:
+    /**
+     * @brief Builds and stores an error message to send to the server.
+     * @param content Content of the error message.
+     */
+    void buildErrMsg(std::string_view content) override;
+
+    /**
+     * @brief Builds an AUTH message using user's username and his secret.
+     * @param username user's username.
+     * @param secret user's secret.
+     */
+    void buildAuthMsg(std::string_view username, std::string_view secret) override;
+
+    /**
+     * @brief Builds a JOIN message using channel id.
+     * @param channel_id id of the channel the user wants to join.
+     */
+    void buildJoinMsg(std::string_view channel_id) override;
+
+    /**
+     * @brief Builds a MSG message from user input.
+    * @param user_msg user's message.
+     */
+    void buildMsgMsg(std::string_view user_msg) override;
+
+    /**
+     * @brief Builds a BYE message for clean disconnection.
+     */
+    void buildByeMsg();
+
+    /**
+     * @brief Sends an AUTH, JOIN or MSG message entered by the user.
+     * @param user_input Parsed user input.
+     */
+    void processUserInput(const User_input& user_input) override;
+
+    /**
+     * @brief Sends BYE and terminates at the end of user input.
+     */
+    void processEof() override;
+
+    /**
+     * @brief Sends BYE and terminates successfully on SIGINT.
+     */
+    void processInterrupt() override;
+
+    /**
+     * @brief Sends an error message and terminates.
+     * @param reason Description of the failure.
+     */
+    void processTransportFailure(const char* reason) override;
+
+    /**
+     * @brief Handles the expiration of the REPLY timer.
+     * @param name Name of the expired timer.
+     */
+    void processTimerEvent(Timer_name name) override;
+
+    /**
+     * @brief Sends BYE and terminates successfully.
+     */
+    void sendByeMsgAndTerminate();
+
+    /**
+     * @brief Sends an error message and terminates with a failure.
+     * @param err_msg The error, also printed when the session terminates.
+     */
+    void sendErrMsgAndTerminate(const char* err_msg);
+
+    /**
+     * @brief Processes a server BYE message.
+     * @param bye_msg_from_server The parsed BYE server message.
+     */
+    void processServerByeMsg(const Tcp_server_msg& bye_msg_from_server);
+
+    /**
+     * @brief Processes a server ERR message.
+     * @param err_msg_from_server The parsed ERR server message.
+     */
+    void processServerErrMsg(const Tcp_server_msg& err_msg_from_server);
+
+    /**
+     * @brief Processes a server MSG message.
+     * @param msg_msg_from_server The parsed MSG server message.
+     */
+    void processServerMsgMsg(const Tcp_server_msg& msg_msg_from_server);
+
+    /**
+     * @brief Processes a server REPLY message.
+     * @param reply_msg_from_server The parsed REPLY server message.
+     */
+    void processServerReplyMsg(const Tcp_server_msg& reply_msg_from_server);
+
+    /**
+     * @brief Processes an incoming server message.
+     * @param msg_from_server The full message received from the server.
+     */
+    void processMessageFromServer(std::string_view msg_from_server);
+
+    /// @brief Size of the receive buffer: an incomplete message shorter than s_MAX_MSG_SIZE plus one full read.
+    static constexpr std::size_t s_RECEIVE_BUFFER_SIZE{2 * s_MAX_MSG_SIZE};
+
+    /// @brief Internal buffer for messages received from the server.
+    Tcp_stream_buffer m_msg_from_server;
+};
+
+#endif // TCP_SESSION_H
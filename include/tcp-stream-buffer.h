@@ -0,0 +1,67 @@
+/**
+ * @file tcp-stream-buffer.h
+ * @author Andrii Klymenko
+ * @brief Fixed-capacity buffer reassembling messages from the TCP byte stream.
+ */
+
+#ifndef TCP_STREAM_BUFFER_H
+#define TCP_STREAM_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+/**
+ * @class Tcp_stream_buffer
+ * @brief Linear receive buffer that splits the TCP byte stream into terminator-delimited frames.
+ *
+ * Data is received directly into the free space at the end of the buffer. Only bytes that have not been
+ * searched yet are scanned for the terminator, complete frames are handed out as views into the buffer
+ * and the incomplete tail is moved to the front at most once per read by compact().
+ */
+class Tcp_stream_buffer {
+public:
+    /**
+     * @brief Constructs an empty buffer.
+     * @param capacity Number of bytes the buffer can hold.
+     * @param frame_terminator Sequence of bytes terminating each frame.
+     */
+    Tcp_stream_buffer(std::size_t capacity, std::string_view frame_terminator);
+
+    /// @return Pointer to the free space where next received data should be stored.
+    char* getFreeSpace();
+
+    /// @return Number of bytes that can be stored at getFreeSpace().
+    std::size_t getFreeSpaceSize() const;
+
+    /**
+     * @brief Marks bytes stored at getFreeSpace() as received.
+     * @param received_bytes Number of received bytes.
+     */
+    void commit(std::size_t received_bytes);
+
+    /**
+     * @brief Extracts the next complete frame (including its terminator).
+     * @param frame Set to a view of the frame; valid until the next call of compact().
+     * @return True if a complete frame was found, false if only an incomplete frame is left.
+     */
+    bool nextFrame(std::string_view& frame);
+
+    /// @return Number of received bytes not belonging to any complete frame extracted so far.
+    std::size_t getPendingSize() const;
+
+    /**
+     * @brief Moves the incomplete tail to the beginning of the buffer to make room for new data.
+     */
+    void compact();
+
+private:
+    std::unique_ptr<char[]> m_data;        ///< Storage.
+    std::size_t m_capacity;                ///< Size of the storage.
+    std::string_view m_frame_terminator;   ///< Sequence of bytes terminating each frame.
+    std::size_t m_begin{0};                ///< Start of the first not yet extracted byte.
+    std::size_t m_end{0};                  ///< End of received data.
+    std::size_t m_scan{0};                 ///< Position from which the terminator hasn't been searched for yet.
+};
+
+#endif // TCP_STREAM_BUFFER_H
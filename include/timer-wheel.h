@@ -0,0 +1,127 @@
+/**
+ * @file timer-wheel.h
+ * @author Andrii Klymenko
+ * @brief Hashed timer wheel multiplexing named deadlines onto a single timer file descriptor.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Kinds of deadlines a client can wait for.
+ */
+enum class Timer_kind : uint8_t
+{
+    T_REPLY,            ///< Waiting for a REPLY to AUTH or JOIN.
+    T_RETRANSMISSION,   ///< Waiting for a CONFIRM of a UDP message.
+    T_CONNECT_ATTEMPT,  ///< Delay before the next TCP connection attempt.
+    T_CONNECT_DEADLINE, ///< Deadline of establishing the TCP connection.
+    T_INPUT,            ///< Delayed line of user input (think time of a load session).
+    T_SEND_DEADLINE,    ///< Deadline of sending the queued messages of a terminating TCP session.
+};
+
+/**
+ * @brief Name of a deadline: its kind and the MessageID it belongs to (0 if not applicable).
+ */
+struct Timer_name {
+    Timer_kind kind{Timer_kind::T_REPLY}; ///< Kind of the deadline.
+    uint16_t msg_id{0};                   ///< MessageID the deadline belongs to.
+};
+
+/**
+ * @class Timer_wheel
+ * @brief Single-level hashed timer wheel with millisecond ticks.
+ *
+ * Timers are kept in doubly-linked lists (one per slot) inside a pool of nodes, so scheduling and
+ * cancelling a timer are O(1). Deadlines more than one rotation ahead stay in their slot until the
+ * wheel reaches their tick. The earliest deadline is cached and recomputed only after it was removed, by scanning
+ * the slots forward from the current tick (at most one rotation). A handle carries the generation of its node, so
+ * cancelling a timer that has already expired (or been cancelled) does nothing even after the node has been reused.
+ */
+class Timer_wheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Handle of a scheduled timer: generation of the node in the upper 32 bits, index of the node in the lower ones.
+    using Timer_handle = uint64_t;
+
+    /// Handle that doesn't refer to any timer.
+    static constexpr Timer_handle s_INVALID_HANDLE{UINT64_MAX};
+
+    /**
+     * @brief Constructs an empty wheel.
+     * @param now Current time (a simulated clock may start anywhere).
+     */
+    explicit Timer_wheel(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Schedules a named deadline.
+     * @param deadline When the timer expires (rounded up to the next millisecond).
+     * @param name Name reported when the timer expires.
+     * @return Handle to cancel the timer with.
+     */
+    Timer_handle schedule(Clock::time_point deadline, Timer_name name);
+
+    /**
+     * @brief Cancels a scheduled timer and invalidates its handle. Does nothing else for s_INVALID_HANDLE or a handle
+     * of a timer that has already expired or been cancelled.
+     * @param handle Handle returned by schedule().
+     */
+    void cancel(Timer_handle& handle);
+
+    /**
+     * @brief Removes all timers that have expired by the given point in time.
+     * @param now Current time.
+     * @param expired_names Names of the expired timers are appended here, in the order of their deadlines' slots.
+     */
+    void expire(Clock::time_point now, std::vector<Timer_name>& expired_names);
+
+    /// @return The earliest deadline of all scheduled timers, or nothing if there is none.
+    std::optional<Clock::time_point> getEarliestDeadline();
+
+private:
+    /// Index of a node in the pool.
+    using Node_index = uint32_t;
+
+    /// Index that doesn't refer to any node.
+    static constexpr Node_index s_NO_NODE{UINT32_MAX};
+
+    /// Number of slots (one per millisecond).
+    static constexpr uint32_t s_SLOT_COUNT{1024};
+
+    /**
+     * @brief Scheduled timer.
+     */
+    struct Node {
+        int64_t expiry_tick{0};     ///< Tick (millisecond) of the expiration.
+        Timer_name name{};          ///< Name of the timer.
+        Node_index prev{s_NO_NODE}; ///< Previous node in the slot (or in the free list).
+        Node_index next{s_NO_NODE}; ///< Next node in the slot (or in the free list).
+        uint32_t generation{0};     ///< Incremented whenever the node is released, invalidating its handles.
+    };
+
+    std::vector<Node> m_nodes{};                                 ///< Pool of nodes.
+    std::array<Node_index, s_SLOT_COUNT> m_slots{};              ///< First node of each slot.
+    Node_index m_free_nodes{s_NO_NODE};                          ///< First node of the free list.
+    int64_t m_current_tick;                                      ///< All ticks before this one have been expired.
+    std::size_t m_scheduled_count{0};                            ///< Number of scheduled timers.
+    std::optional<int64_t> m_earliest_tick{};                    ///< Cached earliest expiry tick.
+    bool m_is_earliest_tick_valid{true};                         ///< False if the cache must be recomputed.
+
+    /// @brief Converts a point in time to a tick, rounding up.
+    static int64_t toTick(Clock::time_point time_point);
+
+    /// @brief Finds the earliest expiry tick of the scheduled timers (nothing if there is none).
+    std::optional<int64_t> findEarliestTick() const;
+
+    /// @brief Removes a node from its slot and returns it to the free list.
+    void release(Node_index index);
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,76 @@
+/**
+ * @file udp-msg-decoder.h
+ * @author Andrii Klymenko
+ * @brief Table-driven decoder of datagrams received by the UDP version of IPK25-CHAT client.
+ */
+
+#ifndef UDP_MSG_DECODER_H
+#define UDP_MSG_DECODER_H
+
+#include "protocol-msg-type.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Result of decoding one datagram received from the server.
+ *
+ * All views point into the receive buffer and are valid only until the next datagram is received into it.
+ */
+struct Udp_server_msg {
+    Protocol_msg_type type{Protocol_msg_type::M_UNKNOWN}; ///< Message type taken from the first byte.
+    bool is_valid{false};                                 ///< True if the datagram matches the layout of its type.
+    uint16_t msg_id{};                                    ///< MessageID field (all types except CONFIRM).
+    uint16_t ref_msg_id{};                                ///< Ref_MessageID field (CONFIRM and REPLY).
+    bool is_positive_reply{false};                        ///< Result field of REPLY.
+    std::string_view display_name{};                      ///< DisplayName field of MSG, ERR and BYE (without terminator).
+    std::string_view content{};                           ///< MessageContent field of MSG, ERR and REPLY (without terminator).
+};
+
+/**
+ * @class Udp_msg_decoder
+ * @brief Decodes IPK25-CHAT datagrams in place using a per-type layout table.
+ *
+ * Variable-length fields are located with memchr() and validated against the Char_class lookup table,
+ * so no part of the datagram is copied.
+ */
+class Udp_msg_decoder {
+public:
+    /**
+     * @brief Decodes one datagram.
+     * @param datagram The datagram exactly as returned by recvfrom().
+     * @return Decoded message with views into the datagram.
+     */
+    static Udp_server_msg decode(std::string_view datagram);
+
+private:
+    /// Maximum number of variable-length fields of a message received from the server.
+    static constexpr uint8_t s_MAX_VARIABLE_FIELDS{2};
+
+    /**
+     * @brief Wire layout of one message type.
+     */
+    struct Msg_layout {
+        bool is_expected{false};         ///< False for types the server is not supposed to send.
+        unsigned min_length{};           ///< Minimal datagram length.
+        unsigned max_length{};           ///< Maximal datagram length.
+        uint8_t fixed_part_length{};     ///< Number of bytes preceding the first variable-length field.
+        uint8_t variable_field_count{};  ///< Number of NUL-terminated fields following the fixed part.
+        std::array<uint8_t, s_MAX_VARIABLE_FIELDS> field_classes{};                        ///< Char_class flags of the fields.
+        std::array<std::string_view Udp_server_msg::*, s_MAX_VARIABLE_FIELDS> field_targets{}; ///< Where to store the fields.
+    };
+
+    /**
+     * @brief Gets the layout table indexed by the message type byte.
+     */
+    static const std::array<Msg_layout, 256>& getLayouts();
+
+    /**
+     * @brief Reads a 16-bit field stored in network byte order.
+     * @param datagram The datagram.
+     * @param offset Offset of the field.
+     */
+    static uint16_t readUint16(std::string_view datagram, std::size_t offset);
+};
+
+#endif // UDP_MSG_DECODER_H
@@ -0,0 +1,231 @@
+/**
+ * @file udp-session.h
+ * @author Andrii Klymenko
+ * @brief Protocol core of the UDP version of IPK25-CHAT client.
+ */
+
+#ifndef UDP_SESSION_H
+#define UDP_SESSION_H
+
+#include "protocol-session.h"
+#include "udp-msg-decoder.h"
+#include "retransmission-queue.h"
+#include "rtt-estimator.h"
+#include "replay-window.h"
+#include <array>
+#include <string>
+
+/**
+ * @class Udp_session
+ * @brief Binary IPK25-CHAT over datagrams: confirmations, retransmissions and the window of unconfirmed messages.
+ *
+ * Every A_SEND is one datagram. A_FOLLOW_PEER is returned for the first REPLY in the AUTH state: the server continues
+ * from its dynamic port, i.e. the source address of the datagram just passed to processDatagram().
+ */
+class Udp_session : public Protocol_session {
+private:
+    /// The decoder reads the wire format constants below.
+    friend class Udp_msg_decoder;
+
+    /// Number of bytes used to encode a message ID
+    static constexpr uint8_t s_BYTES_IN_MSG_ID{sizeof(uint16_t)};
+
+    /// Character used to terminate variable-length data
+    static constexpr char s_VARIABLE_LENGTH_DATA_TERMINATOR{'\0'};
+
+    /// The terminator as a part of an encoded message
+    static constexpr std::string_view s_VARIABLE_LENGTH_DATA_END{&s_VARIABLE_LENGTH_DATA_TERMINATOR, 1};
+
+    /// Number of bytes in protocol message type field
+    static constexpr uint8_t s_BYTES_IN_PROTOCOL_MSG_TYPE{1};
+
+    /// Number of bytes in reply result field
+    static constexpr uint8_t s_BYTES_IN_REPLY_RESULT{1};
+
+public:
+    /// Total header size of a protocol message (the whole CONFIRM message)
+    static constexpr uint8_t s_BYTES_IN_MSG_HEADER{s_BYTES_IN_PROTOCOL_MSG_TYPE + s_BYTES_IN_MSG_ID};
+
+    /// Maximum size of a message (header + payload + terminator)
+    static constexpr int s_MAX_MSG_SIZE{s_BYTES_IN_MSG_HEADER + s_BYTES_IN_REPLY_RESULT +
+        s_BYTES_IN_MSG_ID + s_MSG_CONTENT_MAX_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR)};
+
+    /**
+     * @brief Constructs a session in the START state.
+     * @param config Confirmation timeouts, retransmissions and the window size.
+     * @param now Current time.
+     */
+    Udp_session(const Session_config& config, Clock::time_point now);
+
+    /**
+     * @brief Processes a datagram received from the server.
+     * @param datagram The datagram (possibly longer than s_MAX_MSG_SIZE).
+     * @param now Current time.
+     */
+    const Action_list& processDatagram(std::string_view datagram, Clock::time_point now);
+
+    /// @return True if the window has room and no REPLY is awaited.
+    bool isUserInputEnabled() const override;
+
+private:
+    /**
+     * @brief Builds and stores an error message to send to the server.
+     * @param content Content of the error message.
+     */
+    void buildErrMsg(std::string_view content) override;
+
+    /**
+     * @brief Builds an AUTH message using user's username and his secret.
+     * @param username user's username.
+     * @param secret user's secret.
+     */
+    void buildAuthMsg(std::string_view username, std::string_view secret) override;
+
+    /**
+     * @brief Builds a JOIN message using channel id.
+     * @param channel_id id of the channel the user wants to join.
+     */
+    void buildJoinMsg(std::string_view channel_id) override;
+
+    /**
+     * @brief Builds a MSG message from user input.
+     * @param user_msg user's message.
+     */
+    void buildMsgMsg(std::string_view user_msg) override;
+
+    /**
+     * @brief Builds a BYE message for clean disconnection.
+     */
+    void buildByeMsg();
+
+    /**
+     * @brief Encodes the header of the message being built for the server.
+     * @param type Type of the message.
+     * @return View of the header (valid until the next call).
+     */
+    std::string_view encodeMsgHeader(Protocol_msg_type type);
+
+    /**
+     * @brief Sends the constructed message to the server and adds it to the retransmission queue.
+     */
+    void sendMsgToServer();
+
+    /**
+     * @brief Sends a CONFIRM message acknowledging a received message.
+     * @param ref_msg_id The ID of the message being confirmed.
+     */
+    void sendConfirmMsg(uint16_t ref_msg_id);
+
+    /**
+     * @brief Sends an AUTH, JOIN or MSG message entered by the user.
+     * @param user_input Parsed user input.
+     */
+    void processUserInput(const User_input& user_input) override;
+
+    /**
+     * @brief Sends BYE at the end of user input (unless the session is already terminating).
+     */
+    void processEof() override;
+
+    /**
+     * @brief Sends BYE on SIGINT.
+     */
+    void processInterrupt() override;
+
+    /**
+     * @brief Prints the failure and sends an error message.
+     * @param reason Description of the failure.
+     */
+    void processTransportFailure(const char* reason) override;
+
+    /**
+     * @brief Retransmits the message whose CONFIRM timed out, or terminates if the REPLY timed out.
+     * @param name Name of the expired timer.
+     */
+    void processTimerEvent(Timer_name name) override;
+
+    /**
+     * @brief Invalidates the stored handle of an expired REPLY or retransmission timer.
+     * @param name Name of the expired timer.
+     */
+    void forgetExpiredTimer(Timer_name name) override;
+
+    /**
+     * @brief Processes an incoming PING message from the server.
+     * @param ping_msg The decoded message.
+     */
+    void processServerPingMsg(const Udp_server_msg& ping_msg);
+
+    /**
+     * @brief Processes a BYE message from the server.
+     * @param bye_msg The decoded message.
+     */
+    void processServerByeMsg(const Udp_server_msg& bye_msg);
+
+    /**
+     * @brief Processes an ERR message from the server.
+     * @param err_msg The decoded message.
+     */
+    void processServerErrMsg(const Udp_server_msg& err_msg);
+
+    /**
+     * @brief Processes a MSG message from the server.
+     * @param msg_msg The decoded message.
+     */
+    void processServerMsgMsg(const Udp_server_msg& msg_msg);
+
+    /**
+     * @brief Processes a REPLY message from the server.
+     * @param reply_msg The decoded message.
+     */
+    void processServerReplyMsg(const Udp_server_msg& reply_msg);
+
+    /**
+     * @brief Processes a CONFIRM message from the server.
+     * @param confirm_msg The decoded message.
+     */
+    void processServerConfirmMsg(const Udp_server_msg& confirm_msg);
+
+    /**
+     * @brief Processes any incoming message from the server.
+     * @param msg_from_server The decoded message.
+     */
+    void processMessageFromServer(const Udp_server_msg& msg_from_server);
+
+    /**
+     * @brief Prints an error and sends it to the server.
+     * @param err_msg The error with the "ERROR: " prefix (the whole error is the content of the ERR message).
+     */
+    void sendErrMsg(std::string_view err_msg);
+
+    /**
+     * @brief Sends the built ERR or BYE message, dropping all unconfirmed messages and blocking user input.
+     */
+    void terminate();
+
+    /**
+     * @return Time to wait for a CONFIRM before retransmitting a message.
+     */
+    std::chrono::milliseconds getConfirmTimeout() const;
+
+    /**
+     * @brief Starts waiting for the REPLY to a confirmed AUTH or JOIN message.
+     */
+    void startReplyWait();
+
+    Session_config m_config;                          ///< Timeouts, retransmissions and the window size.
+    uint16_t m_msg_to_server_id{0};                   ///< MessageID of the next message sent to the server.
+    std::array<char, s_BYTES_IN_MSG_HEADER> m_msg_to_server_header{}; ///< Header of the message being built.
+    std::array<char, s_BYTES_IN_MSG_HEADER> m_confirm_msg{};          ///< CONFIRM of the datagram being processed.
+    std::string m_transport_err_msg{};                ///< Content of the ERR message sent because of a transport failure.
+    Retransmission_queue m_retransmission_queue;      ///< Sent messages waiting for a CONFIRM.
+    Rtt_estimator m_rtt_estimator;                    ///< Adaptive confirmation timeout (unused if fixed).
+    Replay_window m_confirmed_server_messages{};      ///< Recently confirmed server message IDs.
+    uint16_t m_reply_ref_msg_id{0};                   ///< MessageID of the AUTH or JOIN waiting for a REPLY.
+    bool m_is_terminating{false};                     ///< True once ERR or BYE has been sent.
+    bool m_is_peer_followed{false};                   ///< True once A_FOLLOW_PEER has been returned.
+
+    static constexpr uint8_t s_MIN_VARIABLE_DATA_LENGTH{1};
+};
+
+#endif // UDP_SESSION_H
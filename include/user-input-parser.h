@@ -0,0 +1,79 @@
+/**
+ * @file user-input-parser.h
+ * @author Andrii Klymenko
+ * @brief Single-pass parser of the user's commands and chat messages.
+ */
+
+#ifndef USER_INPUT_PARSER_H
+#define USER_INPUT_PARSER_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Kinds of user input.
+ */
+enum class User_input_type : uint8_t
+{
+    U_INVALID, ///< Line not matching any command nor a chat message.
+    U_AUTH,    ///< /auth {Username} {Secret} {DisplayName}
+    U_JOIN,    ///< /join {ChannelID}
+    U_RENAME,  ///< /rename {DisplayName}
+    U_HELP,    ///< /help
+    U_MSG,     ///< Chat message.
+};
+
+/**
+ * @brief Result of parsing one line of user input.
+ *
+ * All views point into the line the input was parsed from and are valid only as long as that line is.
+ */
+struct User_input {
+    User_input_type type{User_input_type::U_INVALID}; ///< Kind of the input.
+    std::string_view username{};                      ///< Username of /auth.
+    std::string_view secret{};                        ///< Secret of /auth.
+    std::string_view display_name{};                  ///< Display name of /auth and /rename.
+    std::string_view channel_id{};                    ///< Channel ID of /join.
+    std::string_view content{};                       ///< Content of a chat message.
+};
+
+/**
+ * @class User_input_parser
+ * @brief Allocation-free parser dispatching on the first bytes of a line and validating fields with Char_class.
+ *
+ * Accepts exactly the lines that the following regular expressions (tried in this order) would accept:
+ * - (/auth) ([a-zA-Z0-9_-]+) ([a-zA-Z0-9_-]+) ([!-~]+)
+ * - (/join) ([a-zA-Z0-9_-]+)
+ * - (/rename) ([!-~]+)
+ * - (/help)
+ * - ([\x20-\x7E\n]+) not starting with '/'
+ */
+class User_input_parser {
+public:
+    /**
+     * @brief Classifies and validates one line of user input.
+     * @param line The line without LF.
+     * @return Parsed input with views into line.
+     */
+    static User_input parse(std::string_view line);
+
+private:
+    /**
+     * @brief Consumes a keyword from the beginning of the line.
+     * @param line Rest of the line; advanced past the keyword on success.
+     * @param keyword The keyword (compared case-sensitively).
+     * @return True if the line starts with the keyword.
+     */
+    static bool consumeKeyword(std::string_view& line, std::string_view keyword);
+
+    /**
+     * @brief Consumes a non-empty run of characters of the given class from the beginning of the line.
+     * @param line Rest of the line; advanced past the run on success.
+     * @param char_class One of the Char_class::s_* flags.
+     * @param field Set to the consumed run.
+     * @return True if at least one character was consumed.
+     */
+    static bool consumeField(std::string_view& line, uint8_t char_class, std::string_view& field);
+};
+
+#endif // USER_INPUT_PARSER_H
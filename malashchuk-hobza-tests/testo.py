@@ -1027,8 +1027,14 @@ def udp_reports_error_when_missing_confirmation(tester):
     # Receive AUTH, but DO NOT confirm it
     tester.send_confirm = False
     tester.execute("Hello!")
-    sleep(2)
-    stdout = tester.get_stdout()
+    # The adaptive timeout doubles with every retransmission, up to 5 s (-M), so the client may give up only after
+    # 20 s; the output is checked until the ERROR appears
+    stdout = ""
+    for _ in range(40):
+        sleep(0.5)
+        stdout += tester.get_stdout()
+        if "ERROR: " in stdout:
+            break
     assert any(
         ["ERROR: " in line for line in stdout.split("\n")]
     ), "Output does not match expected 'ERROR: ' output."
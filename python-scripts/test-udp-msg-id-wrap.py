@@ -0,0 +1,70 @@
+# IPK25chat client UDP MessageID wrap-around test
+# usage: python3 test-udp-msg-id-wrap.py <path_to_client_executable>
+# Pushes more than 65536 MSG messages (so the 16-bit MessageID wraps around) through the UDP client,
+# every message is sent twice and the client has to print each one exactly once.
+
+import socket
+import struct
+import subprocess
+import sys
+import threading
+
+ADDRESS = "127.0.0.1"
+PORT = 4567
+MSG_COUNT = 70000
+
+def read_stdout(process: subprocess.Popen, lines: list) -> None:
+    for line in process.stdout:
+        lines.append(line.rstrip("\n"))
+
+def msg_msg(msg_id: int, content: str) -> bytes:
+    return struct.pack("!BH", 0x04, msg_id) + b"server\x00" + content.encode("ascii") + b"\x00"
+
+sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+sock.bind((ADDRESS, PORT))
+sock.settimeout(5)
+
+client = subprocess.Popen([sys.argv[1], "-t", "udp", "-s", ADDRESS, "-p", str(PORT)],
+                          stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+lines = []
+reader = threading.Thread(target=read_stdout, args=(client, lines), daemon=True)
+reader.start()
+
+client.stdin.write("/auth a b c\n")
+client.stdin.flush()
+auth, client_addr = sock.recvfrom(65535)
+sock.sendto(b"\x00" + auth[1:3], client_addr)
+sock.sendto(struct.pack("!BHBH", 0x01, 0, 1, struct.unpack("!H", auth[1:3])[0]) + b"ok\x00", client_addr)
+
+confirmed = 0
+expected_confirms = 1 + 2 * MSG_COUNT
+
+for i in range(MSG_COUNT):
+    msg_id = (i + 1) % 65536
+    sock.sendto(msg_msg(msg_id, f"msg {i}"), client_addr)
+    sock.sendto(msg_msg(msg_id, f"msg {i}"), client_addr) # duplicate
+
+    # keep the number of datagrams in flight below the socket buffer sizes
+    while confirmed < 2 * (i + 1) - 64:
+        sock.recvfrom(65535)
+        confirmed += 1
+
+while confirmed < expected_confirms:
+    sock.recvfrom(65535)
+    confirmed += 1
+
+client.stdin.close()
+bye, _ = sock.recvfrom(65535)
+sock.sendto(b"\x00" + bye[1:3], client_addr)
+client.wait(timeout=5)
+reader.join(timeout=5)
+
+received = [line for line in lines if line.startswith("server: ")]
+expected = [f"server: msg {i}" for i in range(MSG_COUNT)]
+
+if received != expected:
+    missing = len(set(expected) - set(received))
+    print(f"FAILED: printed {len(received)} messages ({missing} missing), expected {MSG_COUNT} unique ones")
+    sys.exit(1)
+
+print(f"OK: {MSG_COUNT} messages printed exactly once")
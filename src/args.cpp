@@ -10,18 +10,23 @@
 
 #include "error.h"
 #include "exception.h"
+#include "socket-address.h"
 #include <iostream>
-#include <arpa/inet.h> // inet_pton()
-#include <netdb.h>     // getaddrinfo(), struct addrinfo
-#include <cstring>     // std::memcpy()
+#include <cstring>     // strlen(), strcmp()
+#include <limits>
 
 Args::Args(const int argc, char** argv)
     :
     m_server_port{4567},
     m_udp_confirm_timeout{250},
     m_udp_max_retrans_count{3},
+    m_udp_window_size{1},
+    m_udp_min_confirm_timeout{10},
+    m_udp_max_confirm_timeout{5000},
+    m_is_udp_confirm_timeout_set{false},
+    m_tcp_connect_timeout{10000},
     m_is_help_used{false},
-    m_arg_flags{'t', 's', 'p', 'd', 'r', 'h'}
+    m_arg_flags{'t', 's', 'p', 'd', 'r', 'h', 'w', 'm', 'M', 'c', 'n', 'f', 'i', 'R'}
 {
     const char* server_addr{nullptr};
 
@@ -55,6 +60,7 @@ Args::Args(const int argc, char** argv)
             else if(argv[i][1] == m_arg_flags[3]) // '-d'
             {
                 m_udp_confirm_timeout = std::stoi(argv[i + 1], nullptr, 10);
+                m_is_udp_confirm_timeout_set = true;
             }
             else if(argv[i][1] == m_arg_flags[4]) // '-r'
             {
@@ -65,56 +71,99 @@ Args::Args(const int argc, char** argv)
                 m_is_help_used = true;
                 return;
             }
-        }
-    }
+            else if(argv[i][1] == m_arg_flags[6]) // '-w'
+            {
+                m_udp_window_size = std::stoi(argv[i + 1], nullptr, 10);
 
-    processServerAddress(server_addr);
-}
+                if(m_udp_window_size == 0)
+                {
+                    throw Exception{"invalid value for -w flag: expected a positive number."};
+                }
+            }
+            else if(argv[i][1] == m_arg_flags[7]) // '-m'
+            {
+                m_udp_min_confirm_timeout = std::stoi(argv[i + 1], nullptr, 10);
+            }
+            else if(argv[i][1] == m_arg_flags[8]) // '-M'
+            {
+                m_udp_max_confirm_timeout = std::stoi(argv[i + 1], nullptr, 10);
+            }
+            else if(argv[i][1] == m_arg_flags[9]) // '-c'
+            {
+                m_tcp_connect_timeout = std::stoi(argv[i + 1], nullptr, 10);
 
-void Args::printHelp()
-{
-    std::cout << "Usage: ./ipk25-chat {-t transport_protocol} {-s serverIP/hostname} [-p server_port] [-d udp_timeout]"
-                 " [-r max_udp_retrans] [-h]\n";
-}
+                if(m_tcp_connect_timeout == 0)
+                {
+                    throw Exception{"invalid value for -c flag: expected a positive number."};
+                }
+            }
+            else if(argv[i][1] == m_arg_flags[10]) // '-n'
+            {
+                m_session_count = parseUint32(argv[i + 1], "invalid value for -n flag: expected a positive number.");
 
-// this function was generated by AI
-void Args::hostnameToIpAddress(const char* hostname)
-{
-    struct addrinfo hints{};
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_STREAM;  // Use TCP by default
+                if(m_session_count == 0)
+                {
+                    throw Exception{"invalid value for -n flag: expected a positive number."};
+                }
+            }
+            else if(argv[i][1] == m_arg_flags[11]) // '-f'
+            {
+                m_script_path = argv[i + 1];
+            }
+            else if(argv[i][1] == m_arg_flags[12]) // '-i'
+            {
+                m_think_time = parseUint32(argv[i + 1], "invalid value for -i flag: expected a number of milliseconds.");
+            }
+            else if(argv[i][1] == m_arg_flags[13]) // '-R'
+            {
+                m_msg_rate = parseUint32(argv[i + 1], "invalid value for -R flag: expected at most 1000 messages per second.");
 
-    struct addrinfo* result{nullptr};
+                // a session reads its script on the millisecond timer wheel, so it can't send more often
+                if(m_msg_rate > s_MAX_MSG_RATE)
+                {
+                    throw Exception{"invalid value for -R flag: expected at most 1000 messages per second."};
+                }
+            }
+        }
+    }
 
-    char portStr[6]{}; // Max 5 digits + null terminator
-    snprintf(portStr, sizeof(portStr), "%d", m_server_port);
+    if(m_udp_min_confirm_timeout == 0 || m_udp_min_confirm_timeout > m_udp_max_confirm_timeout)
+    {
+        throw Exception{"invalid values for -m and -M flags: expected 0 < udp_min_timeout <= udp_max_timeout."};
+    }
 
-    if(getaddrinfo(hostname, portStr, &hints, &result) != 0)
+    if(m_session_count != 0 && m_script_path.empty())
     {
-        throw Exception{"couldn't convert a hostname to IP address."};
+        throw Exception{"missing -f flag: expected the script of the load sessions."};
     }
 
-    std::memcpy(&m_server_addr, result->ai_addr, result->ai_addrlen);
-    freeaddrinfo(result);
+    if(server_addr == nullptr)
+    {
+        throw Exception{"missing -s flag: expected the server's IP address or hostname."};
+    }
+
+    // The hostname is resolved by the client loop, see Host_resolver
+    m_server_hostname = server_addr;
 }
 
-// this function was generated by AI
-void Args::processServerAddress(const char* server_addr)
+uint32_t Args::parseUint32(const char* value, std::string_view error_msg)
 {
-    const int result{inet_pton(AF_INET, server_addr, &m_server_addr.sin_addr)};
+    // std::stoul() accepts values of unsigned long and wraps negative ones
+    const unsigned long number{std::stoul(value, nullptr, 10)};
 
-    if(result == 0)
+    if(number > std::numeric_limits<uint32_t>::max())
     {
-        hostnameToIpAddress(server_addr);  // Convert hostname to IP
-    }
-    else if (result == -1)
-    {
-        throw Exception{"couldn't convert a network address."};
+        throw Exception{error_msg};
     }
 
-    // Always set port AFTER assigning the address
-    m_server_addr.sin_port = htons(m_server_port);
-    m_server_addr.sin_family = AF_INET;
+    return static_cast<uint32_t> (number);
+}
+
+void Args::printHelp()
+{
+    std::cout << "Usage: ./ipk25-chat {-t transport_protocol} {-s serverIP/hostname} [-p server_port] [-d udp_timeout]"
+                 " [-r max_udp_retrans] [-w udp_window_size] [-m udp_min_timeout] [-M udp_max_timeout]"
+                 " [-c tcp_connect_timeout] [-n session_count -f script [-i think_time] [-R msg_rate]] [-h]\n";
 }
 
 // 'getters'
@@ -124,19 +173,80 @@ bool Args::getIsTcp() const
     return m_is_tcp;
 }
 
+void Args::setIsTcp(const bool is_tcp)
+{
+    m_is_tcp = is_tcp;
+}
+
+void Args::setServerHostname(std::string server_hostname)
+{
+    m_server_hostname = std::move(server_hostname);
+}
+
+void Args::setServerPort(const uint16_t server_port)
+{
+    m_server_port = server_port;
+}
+
 uint8_t Args::getUdpMaxRetransCount() const
 {
     return m_udp_max_retrans_count;
 }
 
-struct sockaddr_in* Args::getServerAddrStructAddress()
+struct sockaddr_storage* Args::getServerAddrStructAddress()
 {
     return &m_server_addr;
 }
 
-int Args::getSizeofServerAddrStruct() const
+const std::string& Args::getServerHostname() const
+{
+    return m_server_hostname;
+}
+
+uint16_t Args::getServerPort() const
+{
+    return m_server_port;
+}
+
+void Args::setServerAddrs(std::vector<struct sockaddr_storage> server_addrs)
+{
+    m_server_addrs = std::move(server_addrs);
+    m_server_addr = m_server_addrs.front();
+}
+
+const std::vector<struct sockaddr_storage>& Args::getServerAddrs() const
+{
+    return m_server_addrs;
+}
+
+uint16_t Args::getTcpConnectTimeout() const
+{
+    return m_tcp_connect_timeout;
+}
+
+uint32_t Args::getSessionCount() const
 {
-    return sizeof(m_server_addr);
+    return m_session_count;
+}
+
+const std::string& Args::getScriptPath() const
+{
+    return m_script_path;
+}
+
+uint32_t Args::getThinkTime() const
+{
+    return m_think_time;
+}
+
+uint32_t Args::getMsgRate() const
+{
+    return m_msg_rate;
+}
+
+socklen_t Args::getSizeofServerAddrStruct() const
+{
+    return getSocketAddressLength(m_server_addr);
 }
 
 uint16_t Args::getUdpConfirmTimeout() const
@@ -144,6 +254,26 @@ uint16_t Args::getUdpConfirmTimeout() const
     return m_udp_confirm_timeout;
 }
 
+uint16_t Args::getUdpWindowSize() const
+{
+    return m_udp_window_size;
+}
+
+uint16_t Args::getUdpMinConfirmTimeout() const
+{
+    return m_udp_min_confirm_timeout;
+}
+
+uint16_t Args::getUdpMaxConfirmTimeout() const
+{
+    return m_udp_max_confirm_timeout;
+}
+
+bool Args::getIsUdpConfirmTimeoutSet() const
+{
+    return m_is_udp_confirm_timeout_set;
+}
+
 bool Args::getIsHelpUsed() const
 {
     return m_is_help_used;
@@ -0,0 +1,44 @@
+/**
+ * @file chat-callbacks.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the callbacks printing the output of the interactive client.
+ */
+
+#include "chat-callbacks.h"
+#include "error.h"
+#include "output-writer.h"
+
+Chat_callbacks Chat_callbacks::createConsole(const bool is_chat_output_enabled)
+{
+    Chat_callbacks callbacks{};
+    callbacks.on_error = [](std::string_view err_msg) { printErrMsg(err_msg); };
+
+    if(!is_chat_output_enabled)
+    {
+        return callbacks;
+    }
+
+    // The writer of the calling thread is used; the interactive client flushes it before its Event_loop waits, the
+    // buffer of any other thread is flushed when the thread exits
+    callbacks.on_message = [](std::string_view display_name, std::string_view content)
+    {
+        Output_writer::getStdout().writeLine({display_name, ": ", content});
+    };
+
+    callbacks.on_reply = [](bool is_positive, std::string_view content)
+    {
+        Output_writer::getStdout().writeLine({"Action ", is_positive ? "Success" : "Failure", ": ", content});
+    };
+
+    callbacks.on_server_error = [](std::string_view display_name, std::string_view content)
+    {
+        Output_writer::getStdout().writeLine({"ERROR FROM ", display_name, ": ", content});
+    };
+
+    callbacks.on_output = [](std::string_view text)
+    {
+        Output_writer::getStdout().writeLine({text});
+    };
+
+    return callbacks;
+}
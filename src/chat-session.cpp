@@ -0,0 +1,31 @@
+/**
+ * @file chat-session.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the handle of a client session embedded into another program.
+ */
+
+#include "chat-session.h"
+#include "client.h"
+
+Chat_session::Chat_session(std::shared_ptr<Line_queue> input)
+    :
+    m_input{std::move(input)}
+{
+}
+
+Chat_session Chat_session::create(Event_loop& event_loop, const Args& args, Chat_callbacks callbacks)
+{
+    std::shared_ptr<Line_queue> input{std::make_shared<Line_queue>()};
+    event_loop.addSession(Client::create(args, event_loop, input, std::move(callbacks)));
+    return Chat_session{std::move(input)};
+}
+
+void Chat_session::send(std::string_view line)
+{
+    m_input->push(line);
+}
+
+void Chat_session::close()
+{
+    m_input->close();
+}
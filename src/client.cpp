@@ -7,434 +7,606 @@
 #include "client.h"
 #include "udp-client.h"
 #include "tcp-client.h"
-#include "error.h"
 #include <exception.h>
 #include <sys/socket.h> // socket()
-#include <iostream>
+#include <unistd.h>     // close()
+#include <algorithm>
+#include <utility> // std::exchange()
 
-Client::Client(const Args& args)
+Client::Client(const Args& args, Event_loop& event_loop, std::shared_ptr<Input_source> input_source,
+               Chat_callbacks callbacks)
     :
     m_args{args},
-    m_current_state{FSM_state::S_START},
-    m_user_display_name{"unknown"},
-    m_is_waiting_for_reply{false},
-    m_server_msg{std::make_unique<char[]>(m_args.getIsTcp() ? Tcp_client::s_MAX_MSG_SIZE + 1 : Udp_client::s_MAX_MSG_SIZE + 1)}
-{
-    m_sigint_callback = [this]() { sigintHandler(); };
-    std::signal(SIGINT, [](int) { m_sigint_callback(); });
-    createClientSocket();
-    createEpollFd();
+    m_event_loop{event_loop},
+    m_input_source{std::move(input_source)},
+    m_input_fd{m_input_source->getFileDescriptor()},
+    m_callbacks{std::move(callbacks)}
+{
     createTimerFd();
-
-    addFileDescriptorToEpollEvent(m_stdin_event, STDIN_FILENO);
-    addFileDescriptorToEpollEvent(m_socket_event, m_client_socket);
-    addFileDescriptorToEpollEvent(m_timer_event, m_timer_fd);
     addEntriesToEpollInstance();
+
+    // The socket is created once the result is reported by the resolver's event
+    m_host_resolver.resolve(m_args.getServerHostname(), m_args.getServerPort());
+}
+
+const Session_stats& Client::getStats() const
+{
+    return getSession().getStats();
 }
 
-bool Client::isValidDisplayNameLength(unsigned display_name_length) const
+Receive_stats Client::getReceiveStats() const
 {
-    return display_name_length >= 1 && display_name_length << s_DISPLAY_NAME_MAX_LENGTH;
+    return {};
 }
 
-bool Client::isValidMsgContentLength(unsigned msg_content_length) const
+const Protocol_session& Client::getSession() const
 {
-    return msg_content_length >= 1 && msg_content_length <= s_MSG_CONTENT_MAX_LENGTH;
+    return const_cast<Client*> (this)->getSession();
 }
 
-Protocol_msg_type Client::getUserMsgType(std::string_view command) const
+Session_config Client::getSessionConfig() const
 {
-    if(command == m_user_commands[0])
+    Session_config config{};
+    config.udp_confirm_timeout = std::chrono::milliseconds{m_args.getUdpConfirmTimeout()};
+    config.is_udp_confirm_timeout_fixed = m_args.getIsUdpConfirmTimeoutSet();
+    config.udp_min_confirm_timeout = std::chrono::milliseconds{m_args.getUdpMinConfirmTimeout()};
+    config.udp_max_confirm_timeout = std::chrono::milliseconds{m_args.getUdpMaxConfirmTimeout()};
+    config.udp_max_retransmissions = m_args.getUdpMaxRetransCount();
+    config.udp_window_size = m_args.getUdpWindowSize();
+    return config;
+}
+
+Session_outcome Client::executeActions(const Action_list& actions)
+{
+    bool is_msg_sent{false};
+
+    for(const Protocol_action& action : actions)
     {
-        return Protocol_msg_type::M_AUTH;
+        switch(action.type)
+        {
+            case Action_type::A_SEND:
+            {
+                // Nothing more is sent once the server has closed the connection
+                if(m_send_error != nullptr)
+                {
+                    break;
+                }
+
+                // The iovecs of the message are handed over to the kernel, which needs them non-const
+                Outbound_msg msg{action.msg};
+                sendMsgToServer(msg);
+                is_msg_sent = true;
+                break;
+            }
+
+            case Action_type::A_RECEIVE:
+                reportReceivedMsg(action);
+                break;
+
+            case Action_type::A_PRINT:
+                if(m_callbacks.on_output)
+                {
+                    m_callbacks.on_output(action.content);
+                }
+                break;
+
+            case Action_type::A_PRINT_ERROR:
+                reportError(action.content);
+                break;
+
+            case Action_type::A_SET_TIMER:
+                // the timer file descriptor is re-armed once per loop iteration by updateTimerFd()
+                m_session_deadline = action.deadline;
+                break;
+
+            case Action_type::A_FOLLOW_PEER:
+            {
+                const Session_outcome outcome{followPeer()};
+
+                if(outcome.isFinished())
+                {
+                    return outcome;
+                }
+                break;
+            }
+
+            case Action_type::A_CLOSE:
+            {
+                const Session_outcome outcome{action.is_success ? Session_outcome::succeed()
+                                                                : Session_outcome::fail(action.reason)};
+
+                if(is_msg_sent && m_send_error == nullptr && !finishSending())
+                {
+                    m_closing_outcome = outcome;
+                    return Session_outcome::proceed();
+                }
+
+                if(m_send_error != nullptr)
+                {
+                    // e.g. the BYE hasn't reached the server
+                    m_is_send_error_processed = true;
+                    return action.is_success ? Session_outcome::fail(m_send_error) : outcome;
+                }
+
+                return outcome;
+            }
+        }
     }
 
-    if(command == m_user_commands[2])
+    // The actions refer to the session, so the failure is passed to it only after all of them have been performed
+    if(m_send_error != nullptr && !m_is_send_error_processed)
     {
-        return Protocol_msg_type::M_JOIN;
+        return processSendError();
     }
 
-    return Protocol_msg_type::M_MSG;
-}
-
-void Client::outputIncomingMsg(std::string display_name, std::string content) const
-{
-    std::cout << display_name << ": " << content << std::endl;
+    return Session_outcome::proceed();
 }
 
-void Client::outputIncomingReply(bool is_positive, std::string content) const
+void Client::setSendError(const char* reason)
 {
-    std::cout << "Action " << (is_positive ? "Success" : "Failure") << ": " << content << std::endl;
+    if(m_send_error == nullptr)
+    {
+        m_send_error = reason;
+    }
 }
 
-// this function was generated by AI
-void Client::startTimer(uint16_t time)
+Session_outcome Client::processSendError()
 {
-    struct itimerspec timer_spec{};
-    timer_spec.it_value.tv_sec = time / 1000; // Convert ms to seconds
-    timer_spec.it_value.tv_nsec = (time % 1000) * 1000000; // Convert remainder to nanoseconds
-    timer_spec.it_interval.tv_sec = 0; // One-shot timer
-    timer_spec.it_interval.tv_nsec = 0;
+    m_is_send_error_processed = true;
 
-    if(timerfd_settime(m_timer_fd, 0, &timer_spec, nullptr) == -1)
+    if(getSession().isClosed())
     {
-        throw Exception{"failed to start confirmation timer."};
+        return Session_outcome::fail(m_send_error);
     }
+
+    // The ERR message of the protocol core is dropped; a UDP session would wait for its CONFIRM, so it terminates at
+    // once as well (the error has been reported by the core)
+    const Session_outcome outcome{executeActions(getSession().processTransportError(m_send_error,
+        Timer_wheel::Clock::now()))};
+
+    return outcome.isFinished() ? outcome : Session_outcome::fail({});
+}
+
+bool Client::isClosing() const
+{
+    return m_closing_outcome.has_value();
 }
 
-// this function was generated by AI
-void Client::stopTimer()
+Session_outcome Client::getClosingOutcome() const
 {
-    struct itimerspec timer_spec{};
-    timer_spec.it_value.tv_sec = 0; // Disarm the timer
-    timer_spec.it_value.tv_nsec = 0;
-    timer_spec.it_interval.tv_sec = 0;
-    timer_spec.it_interval.tv_nsec = 0;
+    return *m_closing_outcome;
+}
 
-    if(timerfd_settime(m_timer_fd, 0, &timer_spec, nullptr) == -1)
+void Client::reportReceivedMsg(const Protocol_action& action)
+{
+    switch(action.msg_type)
     {
-        throw Exception{"failed to stop confirmation timer."};
+        case Protocol_msg_type::M_MSG:
+            if(m_callbacks.on_message)
+            {
+                m_callbacks.on_message(action.display_name, action.content);
+            }
+            break;
+
+        case Protocol_msg_type::M_REPLY:
+            if(m_callbacks.on_reply)
+            {
+                m_callbacks.on_reply(action.is_success, action.content);
+            }
+            break;
+
+        case Protocol_msg_type::M_ERR:
+            if(m_callbacks.on_server_error)
+            {
+                m_callbacks.on_server_error(action.display_name, action.content);
+            }
+            break;
+
+        default:
+            break;
     }
 }
 
-void Client::createTimerFd()
+void Client::reportError(std::string_view err_msg)
 {
-    m_timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
-
-    if(m_timer_fd == -1)
+    if(m_callbacks.on_error)
     {
-        throw Exception{"couldn't create timer file descriptor: timerfd_create() has failed."};
+        m_callbacks.on_error(err_msg);
     }
 }
 
-std::unique_ptr<Client> Client::create(const Args& args)
+void Client::reportClose(bool is_success)
 {
-    if(args.getIsTcp())
+    if(m_callbacks.on_close)
     {
-        return std::unique_ptr<Client>(new Tcp_client{args});
+        m_callbacks.on_close(is_success);
     }
+}
 
-    return std::unique_ptr<Client>(new Udp_client{args});
+Timer_wheel::Timer_handle Client::startTimer(Timer_name name, std::chrono::milliseconds timeout)
+{
+    // the timer file descriptor is re-armed once per loop iteration by updateTimerFd()
+    return m_timer_wheel.schedule(Timer_wheel::Clock::now() + timeout, name);
 }
 
-void Client::createClientSocket()
+void Client::stopTimer(Timer_wheel::Timer_handle& handle)
 {
-    if(m_args.getIsTcp())
-    {
-        m_client_socket = socket(AF_INET, SOCK_STREAM, 0);
-    }
-    else
+    m_timer_wheel.cancel(handle);
+}
+
+Session_outcome Client::updateTimerFd()
+{
+    std::optional<Timer_wheel::Clock::time_point> deadline{m_timer_wheel.getEarliestDeadline()};
+
+    if(m_session_deadline && (!deadline || *m_session_deadline < *deadline))
     {
-        m_client_socket = socket(AF_INET, SOCK_DGRAM, 0);
+        deadline = m_session_deadline;
     }
 
-    if(m_client_socket < 0)
+    if(deadline == m_timer_fd_deadline)
     {
-        throw Exception{"couldn't create a client socket: socket() has failed."};
+        return Session_outcome::proceed();
     }
-}
 
-bool Client::processNonMsgToServer(const std::vector<std::string>& user_input)
-{
-    if(user_input[0] == m_user_commands[3])
+    struct itimerspec timer_spec{}; // zero value disarms the timer
+
+    if(deadline)
     {
-        m_user_display_name = user_input[1];
-        return true;
+        // steady_clock is CLOCK_MONOTONIC on Linux, so the deadline can be used as an absolute timer value
+        const auto nanoseconds{std::chrono::duration_cast<std::chrono::nanoseconds>(deadline->time_since_epoch()).count()};
+        timer_spec.it_value.tv_sec = nanoseconds / 1000000000;
+        timer_spec.it_value.tv_nsec = std::max<long>(nanoseconds % 1000000000, 1); // zero would disarm the timer
     }
 
-    if(user_input[0] == m_user_commands[1])
+    if(timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &timer_spec, nullptr) == -1)
     {
-        printSupportedCommands();
-        return true;
+        return Session_outcome::fail("failed to start confirmation timer.");
     }
 
-    return false;
+    m_timer_fd_deadline = deadline;
+    return Session_outcome::proceed();
 }
 
-void Client::buildUserMsgToServer(const std::vector<std::string>& user_input)
+void Client::createTimerFd()
 {
-    switch(getUserMsgType(user_input[0]))
+    m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+    if(m_timer_fd == -1)
     {
-        case Protocol_msg_type::M_AUTH:
-            buildAuthMsg(user_input[1], user_input[2]);
-            break;
-        case Protocol_msg_type::M_JOIN:
-            buildJoinMsg(user_input[1]);
-            break;
-        case Protocol_msg_type::M_MSG:
-            buildMsgMsg(user_input[0]);
-            break;
-        default:
-            throw Exception{"function buildUserMsgToServer() is expected to be called when user enters an auth command"
-                            " or join command or a message."};
+        throw Exception{"couldn't create timer file descriptor: timerfd_create() has failed."};
     }
 }
 
-void Client::printSupportedCommands() const
+Session_outcome Client::processTimerExpiration()
 {
-    std::cout << "Supported commands:\n/auth {Username} {Secret} {DisplayName} - client authentication (signing in)"
-                 " using user-provided username, display name and a password\n/join {ChannelID} - client's request to"
-                 " join a chat channel by its identifier\n/rename {DisplayName} - locally changes the display name of"
-                 " the user to be sent with new messages/selected commands\n/help - prints out supported local commands"
-                 " with their parameters and a description" << std::endl;
-}
+    uint64_t expirations{};
 
-void Client::addFileDescriptorToEpollEvent(struct epoll_event& event, const int file_descriptor)
-{
-    event.data.fd = file_descriptor;
-}
+    if(read(m_timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+    {
+        // The timer was stopped or restarted after its expiration had been reported by epoll_wait()
+        if(errno == EAGAIN)
+        {
+            return Session_outcome::proceed();
+        }
 
-// this function was generated by AI
-void Client::disableStdinEvents()
-{
-    m_stdin_event.events = EPOLLERR | EPOLLHUP;  // Disable EPOLLIN
-    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, STDIN_FILENO, &m_stdin_event) != 0)
+        return Session_outcome::fail("couldn't read the timer file descriptor: read() has failed.");
+    }
+
+    const Timer_wheel::Clock::time_point now{Timer_wheel::Clock::now()};
+
+    m_timer_fd_deadline.reset();
+    m_expired_timers.clear();
+    m_timer_wheel.expire(now, m_expired_timers);
+
+    for(const Timer_name name : m_expired_timers)
+    {
+        // The delayed line is processed with the rest of the queued input
+        if(name.kind == Timer_kind::T_INPUT)
+        {
+            m_input_timer = Timer_wheel::s_INVALID_HANDLE;
+            continue;
+        }
+
+        const Session_outcome outcome{processTimerEvent(name)};
+
+        if(outcome.isFinished())
+        {
+            return outcome;
+        }
+    }
+
+    if(m_session_deadline && *m_session_deadline <= now)
     {
-        throw Exception{"couldn't add an entry to epoll instance: epoll_ctl() has failed."};
+        return executeActions(getSession().processTimers(now));
     }
+
+    return Session_outcome::proceed();
 }
 
-// this function was generated by AI
-void Client::enableStdinEvents()
+std::unique_ptr<Client> Client::create(const Args& args, Event_loop& event_loop,
+                                       std::shared_ptr<Input_source> input_source, Chat_callbacks callbacks)
 {
-    m_stdin_event.events = EPOLLIN | EPOLLERR | EPOLLHUP;  // Enable EPOLLIN again
-    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, STDIN_FILENO, &m_stdin_event) != 0)
+    if(args.getIsTcp())
     {
-        throw Exception{"couldn't add an entry to epoll instance: epoll_ctl() has failed."};
+        return std::unique_ptr<Client>(new Tcp_client{args, event_loop, std::move(input_source), std::move(callbacks)});
     }
+
+    return std::unique_ptr<Client>(new Udp_client{args, event_loop, std::move(input_source), std::move(callbacks)});
 }
 
-void Client::addEntriesToEpollInstance()
+Session_outcome Client::createClientSocket()
 {
-    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_client_socket, &m_socket_event) != 0 ||
-       epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, STDIN_FILENO, &m_stdin_event) != 0 ||
-       epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_timer_fd, &m_timer_event) != 0)
+    m_client_socket = socket(m_args.getServerAddrStructAddress()->ss_family, SOCK_DGRAM, 0);
+
+    if(m_client_socket < 0)
     {
-        throw Exception{"couldn't add an entry to epoll instance: epoll_ctl() has failed."};
+        return Session_outcome::fail("couldn't create a client socket: socket() has failed.");
     }
+
+    m_event_loop.add(m_client_socket, EPOLLIN, *this);
+    return Session_outcome::proceed();
 }
 
-void Client::createEpollFd()
+Session_outcome Client::processResolverEvent()
 {
-    if((m_epoll_fd = epoll_create1(0)) < 0)
+    std::vector<struct sockaddr_storage> server_addrs{m_host_resolver.getResult()};
+
+    // The resolver is used only once
+    m_event_loop.remove(m_host_resolver.getEventFd());
+    m_is_resolver_registered = false;
+
+    if(server_addrs.empty())
     {
-        throw Exception{"couldn't create an epoll file descriptor: epoll_crate1() has failed."};
+        return Session_outcome::fail("couldn't convert a hostname to IP address.");
     }
-}
 
-// Define static function variable
-std::function<void()> Client::m_sigint_callback = nullptr;
+    m_args.setServerAddrs(std::move(server_addrs));
+    return processServerAddrsResolved();
+}
 
-Client::~Client()
+Session_outcome Client::followPeer()
 {
-    close(m_client_socket);
-    close(m_epoll_fd);
+    return Session_outcome::fail("the session can't switch to another server address.");
 }
 
-bool Client::run()
+Session_outcome Client::processTimerEvent(Timer_name)
 {
-    while(true)
-    {
-        // Wait for events
-        m_epoll_event_count = epoll_wait(m_epoll_fd, &m_actual_event, s_MAX_EPOLL_EVENT_NUMBER, -1);
+    return Session_outcome::fail("timer event of an unknown timer.");
+}
 
-        if(m_epoll_event_count == -1)
-        {
-            if(errno == EINTR) // epoll_wait was interrupted by a signal
-            {
-                continue;
-            }
+Session_outcome Client::processConnectEvent(int, uint32_t)
+{
+    return Session_outcome::fail("event on an unknown file descriptor.");
+}
 
-            throw Exception{"epoll_wait() has failed."};
-        }
+bool Client::isUserInputEnabled()
+{
+    return m_client_socket != -1 && getSession().isUserInputEnabled();
+}
 
-        if(m_epoll_event_count == 1)
-        {
-            if(m_actual_event.data.fd == STDIN_FILENO)
-            {
-                processStdinEvent();
-            }
-            else if(m_actual_event.data.fd == m_client_socket)
-            {
-                uint8_t result = processSocketEvent();
+Session_outcome Client::sigintHandler()
+{
+    // Nothing has been sent before the socket exists
+    if(m_client_socket == -1)
+    {
+        return Session_outcome::succeed();
+    }
 
-                if(result == 0 || result == 1)
-                {
-                    return static_cast<bool> (result);
-                }
-            }
-            else
-            {
-                processTimerEvent();
-            }
-        }
+    // Another SIGINT doesn't wait for the last messages any more
+    if(isClosing())
+    {
+        return getClosingOutcome();
     }
 
-    return false;
+    // A TCP session terminates at once, a UDP session waits for the CONFIRM of its BYE
+    return executeActions(getSession().processSigint(Timer_wheel::Clock::now()));
 }
 
-std::vector<std::string> Client::parseUserInput()
+Session_outcome Client::processStdinEvent(uint32_t events)
 {
-    std::string user_input{};
-
-    if(!std::getline(std::cin, user_input))
+    if(events & EPOLLERR)
     {
-        if(std::cin.eof())
-        {
-            sendByeMsgToServer();
-            if(m_args.getIsTcp())
-            {
-                throw Exception{""};
-            }
+        return Session_outcome::fail("stdin error occurred.");
+    }
 
-            return {};
-        }
+    // Hang-up is detected by read() returning 0 once all input has been read
+    if(!m_input_source->read())
+    {
+        return Session_outcome::fail("couldn't read user input: read() has failed.");
     }
 
-    std::smatch user_input_matches{};
+    return Session_outcome::proceed();
+}
 
-    if(std::regex_match(user_input, user_input_matches, getAuthCommandRegex()))
+Session_outcome Client::processQueuedUserInput()
+{
+    std::string_view line{};
+
+    // Lines queued while user input was disabled are processed as soon as it is enabled again
+    while(isUserInputEnabled())
     {
-        if(!canSendMessageType(Protocol_msg_type::M_AUTH))
-        {
-            printErrMsg("you can't send this type of message in the current client state.");
-            return {};
-        }
+        const Input_source::Line_status line_status{m_input_source->nextLine(line)};
 
-        if(user_input_matches[2].length() > s_USERNAME_MAX_LENGTH || user_input_matches[3].length() > s_USER_SECRET_MAX_LENGTH
-           || !isValidDisplayNameLength(user_input_matches[4].length()))
+        if(line_status == Input_source::Line_status::L_NONE)
         {
-            printErrMsg("invalid length of the message parameter.");
-            return {};
+            break;
         }
-    }
-    else if(std::regex_match(user_input, user_input_matches, getJoinCommandRegex()))
-    {
-        if(!canSendMessageType(Protocol_msg_type::M_JOIN))
+
+        if(line_status == Input_source::Line_status::L_TOO_LONG)
         {
-            printErrMsg("you can't send this type of message in the current client state.");
-            return {};
+            reportError("invalid length of the message parameter.");
+            continue;
         }
 
-        if(user_input_matches[2].length() > s_CHANEL_ID_MAX_LENGTH)
+        const Session_outcome outcome{executeActions(getSession().processUserLine(line, Timer_wheel::Clock::now()))};
+
+        if(outcome.isFinished())
         {
-            printErrMsg("invalid length of the message parameter.");
-            return {};
+            return outcome;
         }
     }
-    else if(std::regex_match(user_input, user_input_matches, getRenameCommandRegex()))
+
+    // Without a socket there is no one to say goodbye to yet, the end of input waits for the connection
+    if(m_input_source->isEof() && !m_is_stdin_eof_processed && m_client_socket != -1)
     {
-        if(m_current_state == FSM_state::S_JOIN) // assertion
-        {
-            printErrMsg("you can't rename yourself in the current application state.");
-            return {};
-        }
+        m_is_stdin_eof_processed = true;
+        const Session_outcome outcome{executeActions(getSession().processUserEof(Timer_wheel::Clock::now()))};
 
-        if(!isValidDisplayNameLength(user_input_matches[2].length()))
+        if(outcome.isFinished())
         {
-            printErrMsg("invalid length of the message parameter.");
-            return {};
+            return outcome;
         }
     }
-    else if(std::regex_match(user_input, user_input_matches, getHelpCommandRegex()))
+
+    scheduleDelayedInput();
+    updateStdinRegistration();
+    return Session_outcome::proceed();
+}
+
+void Client::scheduleDelayedInput()
+{
+    const std::optional<Input_source::Clock::time_point> next_line_time{m_input_source->getNextLineTime()};
+
+    if(next_line_time && m_input_timer == Timer_wheel::s_INVALID_HANDLE && isUserInputEnabled())
     {
-        return {user_input};
+        m_input_timer = m_timer_wheel.schedule(*next_line_time, {Timer_kind::T_INPUT});
     }
-    else if(!user_input.empty() && user_input[0] != '/'
-            && std::regex_match(user_input, user_input_matches, getUserMsgRegex()))
+}
+
+void Client::updateStdinRegistration()
+{
+    const bool should_be_registered{m_input_fd != -1 && !m_input_source->isEofRead() && !m_input_source->isFull()};
+
+    if(should_be_registered == m_is_stdin_registered)
     {
-        if(!canSendMessageType(Protocol_msg_type::M_MSG))
-        {
-            printErrMsg("you can't send this type of message in the current client state.");
-            return {};
-        }
+        return;
+    }
 
-        if(!isValidMsgContentLength(user_input_matches[1].length()))
-        {
-            printErrMsg("invalid length of the message parameter.");
-            return {};
-        }
+    if(should_be_registered)
+    {
+        m_event_loop.add(m_input_fd, EPOLLIN, *this);
     }
     else
     {
-        printErrMsg("invalid user input.");
-        return {};
+        m_event_loop.remove(m_input_fd);
     }
 
-    return getUserInput(user_input_matches);
+    m_is_stdin_registered = should_be_registered;
 }
 
-bool Client::canSendMessageType(Protocol_msg_type msg_type) const
+void Client::addEntriesToEpollInstance()
 {
-    if(msg_type == Protocol_msg_type::M_AUTH)
+    m_event_loop.add(m_timer_fd, EPOLLIN, *this);
+    m_event_loop.add(m_host_resolver.getEventFd(), EPOLLIN, *this);
+    m_is_resolver_registered = true;
+    updateStdinRegistration();
+}
+
+Client::~Client()
+{
+    // The resolver's eventfd stays open while its helper thread is running and stdin is never closed
+    if(m_is_resolver_registered)
+    {
+        m_event_loop.remove(m_host_resolver.getEventFd());
+    }
+
+    if(m_is_stdin_registered)
+    {
+        m_event_loop.remove(m_input_fd);
+    }
+
+    if(m_client_socket != -1)
     {
-        return m_current_state == FSM_state::S_START || m_current_state == FSM_state::S_AUTH;
+        m_event_loop.remove(m_client_socket);
+        close(m_client_socket);
     }
 
-    return m_current_state == FSM_state::S_OPEN;
+    m_event_loop.remove(m_timer_fd);
+    close(m_timer_fd);
 }
 
-void Client::printErrFromServer(std::string display_name, std::string message_content) const
+Session_outcome Client::processEvent(int file_descriptor, uint32_t events)
 {
-    std::cout << "ERROR FROM " << display_name << ": " << message_content << std::endl;
+    if(file_descriptor == m_client_socket)
+    {
+        m_socket_events |= events;
+    }
+    else if(file_descriptor == m_timer_fd)
+    {
+        m_timer_events |= events;
+    }
+    else if(file_descriptor == m_input_fd)
+    {
+        m_input_events |= events;
+    }
+    else if(file_descriptor == m_host_resolver.getEventFd())
+    {
+        m_is_resolver_ready = true;
+    }
+    else
+    {
+        return processConnectEvent(file_descriptor, events);
+    }
+
+    return Session_outcome::proceed();
 }
 
-std::vector<std::string> Client::getUserInput(const std::smatch& user_input_matches) const
+Session_outcome Client::processReadyEvents()
 {
-    std::vector<std::string> user_input{};
+    const uint32_t socket_events{std::exchange(m_socket_events, 0)};
+    const uint32_t timer_events{std::exchange(m_timer_events, 0)};
+    const uint32_t input_events{std::exchange(m_input_events, 0)};
 
-    for(int i{0}; i < static_cast<int> (user_input_matches.size()) - 1; ++i)
+    if(std::exchange(m_is_resolver_ready, false))
     {
-        user_input.push_back(user_input_matches[i + 1]);
+        const Session_outcome outcome{processResolverEvent()};
+
+        if(outcome.isFinished())
+        {
+            return outcome;
+        }
     }
 
-    return user_input;
-}
+    // Socket goes first, so that a received CONFIRM or REPLY stops the timer before its expiration is handled
+    if(socket_events != 0)
+    {
+        const Session_outcome outcome{processSocketEvent(socket_events)};
 
-const std::string& Client::getAlphaNumericUnderlineDash()
-{
-    static const std::string value{"([a-zA-Z0-9_-]+)"};
-    return value;
-}
+        if(outcome.isFinished())
+        {
+            return outcome;
+        }
+    }
 
-const std::string& Client::getPrintableChars()
-{
-    static const std::string value{"([!-~]+)"};
-    return value;
-}
+    // Timers stopped by the socket event are no longer in the wheels, so they don't expire
+    if(timer_events != 0)
+    {
+        const Session_outcome outcome{processTimerExpiration()};
 
-const std::string& Client::getPrintableCharsSpaceLf()
-{
-    static const std::string value{"([\x20-\x7E\n]+)"};
-    return value;
-}
+        if(outcome.isFinished())
+        {
+            return outcome;
+        }
+    }
 
-const std::regex& Client::getAuthCommandRegex()
-{
-    static const std::regex value{"(/auth) " + getAlphaNumericUnderlineDash() + " " + getAlphaNumericUnderlineDash() + " " + getPrintableChars()};
-    return value;
-}
+    // Input is queued even if it has been disabled by one of the events above
+    if(input_events != 0)
+    {
+        const Session_outcome outcome{processStdinEvent(input_events)};
 
-const std::regex& Client::getJoinCommandRegex()
-{
-    static const std::regex value{"(/join) " + getAlphaNumericUnderlineDash()};
-    return value;
-}
+        if(outcome.isFinished())
+        {
+            return outcome;
+        }
+    }
 
-const std::regex& Client::getRenameCommandRegex()
-{
-    static const std::regex value{"(/rename) " + getPrintableChars()};
-    return value;
-}
+    const Session_outcome outcome{processQueuedUserInput()};
 
-const std::regex& Client::getHelpCommandRegex()
-{
-    static const std::regex value{"(/help)"};
-    return value;
-}
+    if(outcome.isFinished())
+    {
+        return outcome;
+    }
 
-const std::regex& Client::getUserMsgRegex()
-{
-    static const std::regex value{getPrintableCharsSpaceLf()};
-    return value;
+    // Timers started or stopped by the events are applied at once, before the loop waits again
+    return updateTimerFd();
 }
@@ -4,10 +4,13 @@
  * @brief Definition of utility function for printing protocol's error messages.
  */
 
-#include "err.h"
-#include <iostream>
+#include "error.h"
+#include "output-writer.h"
 
 void printErrMsg(const std::string_view err_msg)
 {
-    std::cout << "ERROR: " << err_msg << std::endl;
+    // error messages are written at once, as they may be the last output of the program
+    Output_writer& output{Output_writer::getStdout()};
+    output.writeLine({"ERROR: ", err_msg});
+    output.flush();
 }
\ No newline at end of file
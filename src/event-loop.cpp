@@ -0,0 +1,346 @@
+/**
+ * @file event-loop.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the epoll loop shared by any number of client sessions.
+ */
+
+#include "event-loop.h"
+#include "client.h"
+#include "exception.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>  // eventfd()
+#include <sys/signalfd.h> // signalfd(), struct signalfd_siginfo
+#include <unistd.h>       // read(), write(), close()
+
+Event_loop::Event_loop(bool is_sigint_received)
+{
+    if((m_epoll_fd = epoll_create1(0)) < 0)
+    {
+        throw Exception{"couldn't create an epoll file descriptor: epoll_create1() has failed."};
+    }
+
+    if((m_interrupt_fd = eventfd(0, EFD_NONBLOCK)) < 0)
+    {
+        close(m_epoll_fd);
+        throw Exception{"couldn't create an event file descriptor: eventfd() has failed."};
+    }
+
+    try
+    {
+        if(is_sigint_received)
+        {
+            m_signal_fd = createSigintFd();
+            addOwnFileDescriptor(m_signal_fd);
+        }
+
+        addOwnFileDescriptor(m_interrupt_fd);
+    }
+    catch(const Exception&)
+    {
+        closeOwnFileDescriptors();
+        throw;
+    }
+}
+
+Event_loop::~Event_loop()
+{
+    // Sessions unregister their file descriptors while they are destroyed
+    m_finished_sessions.clear();
+    m_sessions.clear();
+
+    closeOwnFileDescriptors();
+}
+
+int Event_loop::createSigintFd()
+{
+    sigset_t signals{};
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+
+    int signal_fd{-1};
+
+    // Threads started later (e.g. by Host_resolver) inherit the mask, so SIGINT is received only by the signalfd
+    if(pthread_sigmask(SIG_BLOCK, &signals, nullptr) != 0 || (signal_fd = signalfd(-1, &signals, SFD_NONBLOCK)) < 0)
+    {
+        throw Exception{"couldn't create a signal file descriptor: signalfd() has failed."};
+    }
+
+    return signal_fd;
+}
+
+void Event_loop::addOwnFileDescriptor(int file_descriptor)
+{
+    struct epoll_event event{.events = EPOLLIN, .data = {}};
+    event.data.fd = file_descriptor;
+
+    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, file_descriptor, &event) != 0)
+    {
+        throw Exception{"couldn't add an entry to epoll instance: epoll_ctl() has failed."};
+    }
+}
+
+void Event_loop::closeOwnFileDescriptors()
+{
+    if(m_signal_fd != -1)
+    {
+        close(m_signal_fd);
+    }
+
+    close(m_interrupt_fd);
+    close(m_epoll_fd);
+}
+
+void Event_loop::addSession(std::unique_ptr<Client> session)
+{
+    Client& added_session{*session};
+    m_sessions.emplace(&added_session, std::move(session));
+
+    // Timers started by the constructor are applied before the loop waits
+    markReady(added_session);
+}
+
+void Event_loop::add(int file_descriptor, uint32_t events, Client& owner)
+{
+    struct epoll_event event{.events = events, .data = {}};
+    event.data.fd = file_descriptor;
+
+    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, file_descriptor, &event) != 0)
+    {
+        throw Exception{"couldn't add an entry to epoll instance: epoll_ctl() has failed."};
+    }
+
+    if(static_cast<std::size_t> (file_descriptor) >= m_fd_owners.size())
+    {
+        m_fd_owners.resize(file_descriptor + 1, nullptr);
+    }
+
+    m_fd_owners[file_descriptor] = &owner;
+}
+
+void Event_loop::modify(int file_descriptor, uint32_t events)
+{
+    struct epoll_event event{.events = events, .data = {}};
+    event.data.fd = file_descriptor;
+
+    if(epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, file_descriptor, &event) != 0)
+    {
+        throw Exception{"couldn't modify an entry of epoll instance: epoll_ctl() has failed."};
+    }
+}
+
+void Event_loop::remove(int file_descriptor)
+{
+    // a closed file descriptor would be removed from the epoll instance automatically, a file descriptor kept open wouldn't
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, file_descriptor, nullptr);
+
+    if(static_cast<std::size_t> (file_descriptor) < m_fd_owners.size())
+    {
+        m_fd_owners[file_descriptor] = nullptr;
+    }
+}
+
+const Loop_stats& Event_loop::getStats() const
+{
+    return m_stats;
+}
+
+void Event_loop::interrupt()
+{
+    const uint64_t interrupt_count{1};
+
+    // the eventfd can't overflow with one interrupt per SIGINT
+    [[maybe_unused]] const ssize_t written_bytes{write(m_interrupt_fd, &interrupt_count, sizeof(interrupt_count))};
+}
+
+void Event_loop::setBeforeWaitHook(std::function<void()> hook)
+{
+    m_before_wait_hook = std::move(hook);
+}
+
+void Event_loop::run()
+{
+    std::array<struct epoll_event, s_MAX_EPOLL_EVENT_NUMBER> ready_events{};
+
+    while(true)
+    {
+        processReadySessions();
+
+        if(m_sessions.empty())
+        {
+            return;
+        }
+
+        if(m_before_wait_hook)
+        {
+            m_before_wait_hook();
+        }
+
+        const int ready_event_count{epoll_wait(m_epoll_fd, ready_events.data(), s_MAX_EPOLL_EVENT_NUMBER, -1)};
+
+        if(ready_event_count == -1)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            throw Exception{"epoll_wait() has failed."};
+        }
+
+        for(int i{0}; i < ready_event_count; ++i)
+        {
+            const int file_descriptor{ready_events[i].data.fd};
+
+            if(file_descriptor == m_signal_fd || file_descriptor == m_interrupt_fd)
+            {
+                processSigint(file_descriptor);
+                continue;
+            }
+
+            Client* owner{static_cast<std::size_t> (file_descriptor) < m_fd_owners.size() ? m_fd_owners[file_descriptor] : nullptr};
+
+            // The owner may have been terminated by an earlier event of this iteration
+            if(owner == nullptr || !m_sessions.contains(owner))
+            {
+                continue;
+            }
+
+            try
+            {
+                const Session_outcome outcome{owner->processEvent(file_descriptor, ready_events[i].events)};
+
+                if(outcome.isFinished())
+                {
+                    finishSession(*owner, outcome);
+                    continue;
+                }
+
+                markReady(*owner);
+            }
+            catch(const Exception& e)
+            {
+                finishSession(*owner, e);
+            }
+        }
+    }
+}
+
+void Event_loop::processReadySessions()
+{
+    // A session with several ready file descriptors processes them at once
+    std::sort(m_ready_sessions.begin(), m_ready_sessions.end());
+    m_ready_sessions.erase(std::unique(m_ready_sessions.begin(), m_ready_sessions.end()), m_ready_sessions.end());
+
+    for(Client* session : m_ready_sessions)
+    {
+        if(!m_sessions.contains(session))
+        {
+            continue;
+        }
+
+        try
+        {
+            const Session_outcome outcome{session->processReadyEvents()};
+
+            if(outcome.isFinished())
+            {
+                finishSession(*session, outcome);
+            }
+        }
+        catch(const Exception& e)
+        {
+            finishSession(*session, e);
+        }
+    }
+
+    m_ready_sessions.clear();
+    m_finished_sessions.clear();
+}
+
+void Event_loop::processSigint(int file_descriptor)
+{
+    struct signalfd_siginfo signal_info{};
+    uint64_t interrupt_count{};
+
+    // SIGINTs received since the last read are merged into one
+    if(file_descriptor == m_signal_fd ? read(m_signal_fd, &signal_info, sizeof(signal_info)) != sizeof(signal_info)
+                                      : read(m_interrupt_fd, &interrupt_count, sizeof(interrupt_count)) == -1)
+    {
+        return;
+    }
+
+    std::vector<Client*> sessions{};
+    sessions.reserve(m_sessions.size());
+
+    for(const auto& [session, owned_session] : m_sessions)
+    {
+        sessions.push_back(session);
+    }
+
+    for(Client* session : sessions)
+    {
+        try
+        {
+            const Session_outcome outcome{session->sigintHandler()};
+
+            if(outcome.isFinished())
+            {
+                finishSession(*session, outcome);
+                continue;
+            }
+
+            markReady(*session);
+        }
+        catch(const Exception& e)
+        {
+            finishSession(*session, e);
+        }
+    }
+}
+
+void Event_loop::markReady(Client& session)
+{
+    m_ready_sessions.push_back(&session);
+}
+
+void Event_loop::finishSession(Client& session, const Session_outcome& outcome)
+{
+    if(outcome.type == Outcome_type::O_FAILURE && !outcome.reason.empty())
+    {
+        session.reportError(outcome.reason);
+    }
+
+    finishSession(session, outcome.type == Outcome_type::O_SUCCESS);
+}
+
+void Event_loop::finishSession(Client& session, const Exception& exception)
+{
+    session.reportError(exception.what());
+    finishSession(session, false);
+}
+
+void Event_loop::finishSession(Client& session, bool is_success)
+{
+    const auto it{m_sessions.find(&session)};
+
+    if(is_success)
+    {
+        ++m_stats.succeeded_session_count;
+    }
+    else
+    {
+        ++m_stats.failed_session_count;
+    }
+
+    m_stats.session_totals += session.getStats();
+    m_stats.receive_totals += session.getReceiveStats();
+    session.reportClose(is_success);
+
+    // The session is destroyed at the end of the iteration, other sessions may still have events in the array
+    m_finished_sessions.push_back(std::move(it->second));
+    m_sessions.erase(it);
+}
@@ -17,8 +17,3 @@ const char* Exception::what() const noexcept
 {
     return m_explanation.c_str();
 }
-
-bool Exception::isSigintOrEofReceived() const
-{
-    return m_explanation.empty();
-}
@@ -0,0 +1,192 @@
+/**
+ * @file host-resolver.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the resolution of the server's hostname that doesn't block the client loop.
+ */
+
+#include "host-resolver.h"
+#include "exception.h"
+#include <atomic>
+#include <cstring>       // std::memcpy()
+#include <netdb.h>       // getaddrinfo(), struct addrinfo
+#include <sys/eventfd.h> // eventfd()
+#include <system_error>
+#include <thread>
+#include <unistd.h>      // read(), write(), close()
+
+struct Host_resolver::Resolution {
+    int event_fd{-1};                             ///< Signalled when the result is available.
+    std::atomic<bool> is_done{false};             ///< True once the result has been stored.
+    int error{0};                                 ///< getaddrinfo() error code.
+    std::vector<struct sockaddr_storage> addrs{}; ///< Resolved addresses.
+
+    ~Resolution()
+    {
+        if(event_fd != -1)
+        {
+            close(event_fd);
+        }
+    }
+};
+
+Host_resolver::Shared_state& Host_resolver::getSharedState()
+{
+    // intentionally leaked: static destructors run while detached helper threads may still use the state
+    static Shared_state* const value{new Shared_state{}};
+    return *value;
+}
+
+Host_resolver::Host_resolver()
+    :
+    m_resolution{std::make_shared<Resolution>()}
+{
+    if((m_resolution->event_fd = eventfd(0, EFD_NONBLOCK)) < 0)
+    {
+        throw Exception{"couldn't create an event file descriptor: eventfd() has failed."};
+    }
+}
+
+int Host_resolver::getEventFd() const
+{
+    return m_resolution->event_fd;
+}
+
+void Host_resolver::resolve(const std::string& hostname, uint16_t port)
+{
+    const std::string port_string{std::to_string(port)};
+    std::vector<struct sockaddr_storage> addrs{};
+
+    // getaddrinfo() also handles IPv6 addresses with a zone index (e.g. fe80::1%eth0)
+    if(getAddresses(hostname, port_string, AI_NUMERICHOST, addrs) == 0)
+    {
+        complete(*m_resolution, 0, std::move(addrs));
+        return;
+    }
+
+    const std::string key{hostname + ' ' + port_string};
+
+    {
+        Shared_state& shared_state{getSharedState()};
+        const std::lock_guard<std::mutex> lock{shared_state.mutex};
+        const auto it{shared_state.cache.find(key)};
+
+        if(it != shared_state.cache.end() && it->second.expires_at > std::chrono::steady_clock::now())
+        {
+            complete(*m_resolution, 0, it->second.addrs);
+            return;
+        }
+
+        std::vector<std::shared_ptr<Resolution>>& waiting{shared_state.pending[key]};
+        waiting.push_back(m_resolution);
+
+        // another resolver has already started the helper thread for this hostname
+        if(waiting.size() > 1)
+        {
+            return;
+        }
+    }
+
+    try
+    {
+        std::thread{runResolution, hostname, port_string}.detach();
+    }
+    catch(const std::system_error&)
+    {
+        // resolvers that have joined meanwhile would otherwise wait for a thread that never runs
+        completePending(key, EAI_SYSTEM, {});
+    }
+}
+
+std::vector<struct sockaddr_storage> Host_resolver::getResult()
+{
+    uint64_t completion_count{};
+
+    if(read(m_resolution->event_fd, &completion_count, sizeof(completion_count)) == -1
+       || !m_resolution->is_done.load(std::memory_order_acquire))
+    {
+        throw Exception{"couldn't read the result of the hostname resolution: read() has failed."};
+    }
+
+    // A failed resolution terminates only the session, see Client::processResolverEvent()
+    if(m_resolution->error != 0)
+    {
+        return {};
+    }
+
+    return m_resolution->addrs;
+}
+
+int Host_resolver::getAddresses(const std::string& hostname, const std::string& port, int flags,
+                                std::vector<struct sockaddr_storage>& addrs)
+{
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;      // Both IPv4 and IPv6 addresses
+    hints.ai_socktype = SOCK_STREAM;  // One address per host, not per socket type
+    hints.ai_flags = flags;
+
+    struct addrinfo* result{nullptr};
+    const int error{getaddrinfo(hostname.c_str(), port.c_str(), &hints, &result)};
+
+    if(error != 0)
+    {
+        return error;
+    }
+
+    for(const struct addrinfo* address{result}; address != nullptr; address = address->ai_next)
+    {
+        if(address->ai_family != AF_INET && address->ai_family != AF_INET6)
+        {
+            continue;
+        }
+
+        struct sockaddr_storage server_addr{};
+        std::memcpy(&server_addr, address->ai_addr, address->ai_addrlen);
+        addrs.push_back(server_addr);
+    }
+
+    freeaddrinfo(result);
+    return addrs.empty() ? EAI_NONAME : 0;
+}
+
+void Host_resolver::runResolution(std::string hostname, std::string port)
+{
+    std::vector<struct sockaddr_storage> addrs{};
+    const int error{getAddresses(hostname, port, 0, addrs)};
+
+    completePending(hostname + ' ' + port, error, std::move(addrs));
+}
+
+void Host_resolver::completePending(const std::string& key, int error, std::vector<struct sockaddr_storage> addrs)
+{
+    std::vector<std::shared_ptr<Resolution>> waiting{};
+
+    {
+        Shared_state& shared_state{getSharedState()};
+        const std::lock_guard<std::mutex> lock{shared_state.mutex};
+
+        if(error == 0)
+        {
+            shared_state.cache[key] = {addrs, std::chrono::steady_clock::now() + s_CACHE_TTL};
+        }
+
+        waiting = std::move(shared_state.pending[key]);
+        shared_state.pending.erase(key);
+    }
+
+    for(const std::shared_ptr<Resolution>& resolution : waiting)
+    {
+        complete(*resolution, error, addrs);
+    }
+}
+
+void Host_resolver::complete(Resolution& resolution, int error, std::vector<struct sockaddr_storage> addrs)
+{
+    resolution.error = error;
+    resolution.addrs = std::move(addrs);
+    resolution.is_done.store(true, std::memory_order_release);
+
+    const uint64_t completion_count{1};
+
+    // the eventfd can't overflow with a single completion
+    [[maybe_unused]] const ssize_t written_bytes{write(resolution.event_fd, &completion_count, sizeof(completion_count))};
+}
@@ -0,0 +1,103 @@
+/**
+ * @file line-queue.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the queue of user input lines pushed by the program embedding the client.
+ */
+
+#include "line-queue.h"
+#include "exception.h"
+#include <sys/eventfd.h> // eventfd()
+#include <unistd.h>      // read(), write(), close()
+
+Line_queue::Line_queue()
+    :
+    m_event_fd{eventfd(0, EFD_NONBLOCK)}
+{
+    if(m_event_fd == -1)
+    {
+        throw Exception{"couldn't create an event file descriptor: eventfd() has failed."};
+    }
+}
+
+Line_queue::~Line_queue()
+{
+    ::close(m_event_fd);
+}
+
+void Line_queue::push(std::string_view line)
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_pushed.append(line).push_back('\n');
+    }
+
+    wakeUp();
+}
+
+void Line_queue::close()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_is_close_pushed = true;
+    }
+
+    wakeUp();
+}
+
+void Line_queue::wakeUp()
+{
+    const uint64_t push_count{1};
+
+    // the eventfd can't overflow before the counter is read by the loop
+    [[maybe_unused]] const ssize_t written_bytes{write(m_event_fd, &push_count, sizeof(push_count))};
+}
+
+int Line_queue::getFileDescriptor() const
+{
+    return m_event_fd;
+}
+
+bool Line_queue::read()
+{
+    uint64_t push_count{};
+    [[maybe_unused]] const ssize_t read_bytes{::read(m_event_fd, &push_count, sizeof(push_count))};
+
+    // extracted lines are no longer referenced
+    m_lines.erase(0, m_begin);
+    m_begin = 0;
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    m_lines.append(m_pushed);
+    m_pushed.clear();
+    m_is_eof_read = m_is_close_pushed;
+    return true;
+}
+
+Input_source::Line_status Line_queue::nextLine(std::string_view& line)
+{
+    const std::size_t line_end{m_lines.find('\n', m_begin)};
+
+    if(line_end == std::string::npos)
+    {
+        return Line_status::L_NONE;
+    }
+
+    line = std::string_view{m_lines}.substr(m_begin, line_end - m_begin);
+    m_begin = line_end + 1;
+    return Line_status::L_LINE;
+}
+
+bool Line_queue::isFull() const
+{
+    return false;
+}
+
+bool Line_queue::isEofRead() const
+{
+    return m_is_eof_read;
+}
+
+bool Line_queue::isEof() const
+{
+    return m_is_eof_read && m_begin == m_lines.size();
+}
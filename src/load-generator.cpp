@@ -0,0 +1,101 @@
+/**
+ * @file load-generator.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the load testing mode running many scripted client sessions in one process.
+ */
+
+#include "load-generator.h"
+#include "client.h"
+#include "exception.h"
+#include "output-writer.h"
+#include "script-reader.h"
+#include "sharded-executor.h"
+#include <fstream>
+#include <sys/resource.h> // getrlimit(), setrlimit()
+
+Load_generator::Load_generator(const Args& args)
+    :
+    m_args{args}
+{
+}
+
+bool Load_generator::run()
+{
+    raiseFileDescriptorLimit();
+
+    const std::shared_ptr<const std::vector<std::string>> script{readScript(m_args.getScriptPath())};
+    const std::chrono::milliseconds think_time{m_args.getThinkTime()};
+    const std::chrono::microseconds msg_interval{m_args.getMsgRate() == 0 ? 0 : 1000000 / m_args.getMsgRate()};
+
+    Sharded_executor executor{m_args.getSessionCount()};
+
+    const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+    const Loop_stats stats{executor.run([&](Event_loop& event_loop, uint32_t session_number) {
+        return Client::create(m_args, event_loop,
+                              std::make_unique<Script_reader>(script, session_number, think_time, msg_interval),
+                              Chat_callbacks::createConsole(false));
+    })};
+    printStats(stats, executor.getLoopCount(), std::chrono::steady_clock::now() - start);
+
+    return stats.failed_session_count == 0;
+}
+
+std::shared_ptr<const std::vector<std::string>> Load_generator::readScript(const std::string& path)
+{
+    std::ifstream script_file{path};
+
+    if(!script_file)
+    {
+        throw Exception{"couldn't open the script of the load sessions."};
+    }
+
+    auto script{std::make_shared<std::vector<std::string>>()};
+
+    for(std::string line{}; std::getline(script_file, line);)
+    {
+        script->push_back(line);
+    }
+
+    return script;
+}
+
+void Load_generator::raiseFileDescriptorLimit()
+{
+    struct rlimit limit{};
+
+    // Without the raise the sessions fail one by one once the soft limit (usually 1024) is reached
+    if(getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void Load_generator::printStats(const Loop_stats& stats, std::size_t loop_count, std::chrono::steady_clock::duration duration)
+{
+    const Session_stats& totals{stats.session_totals};
+    const double seconds{std::chrono::duration<double>(duration).count()};
+
+    Output_writer::getStdout().writeLine({"Sessions: ", std::to_string(stats.succeeded_session_count), " succeeded, ",
+        std::to_string(stats.failed_session_count), " failed, ", std::to_string(loop_count), " threads"});
+    Output_writer::getStdout().writeLine({"Sent messages: ", std::to_string(totals.sent_msg_count),
+        ", received messages: ", std::to_string(totals.received_msg_count),
+        ", replies: ", std::to_string(totals.positive_reply_count), " positive, ",
+        std::to_string(totals.negative_reply_count), " negative, errors from server: ",
+        std::to_string(totals.received_err_count)});
+
+    // Shows how many datagrams a single recvmmsg() wakeup drains (only UDP sessions receive datagrams)
+    const Receive_stats& receive_totals{stats.receive_totals};
+
+    if(receive_totals.wakeup_count != 0)
+    {
+        const double datagrams_per_wakeup{static_cast<double> (receive_totals.datagram_count)
+            / static_cast<double> (receive_totals.wakeup_count)};
+
+        Output_writer::getStdout().writeLine({"Received datagrams: ", std::to_string(receive_totals.datagram_count),
+            " in ", std::to_string(receive_totals.wakeup_count), " wakeups, ", std::to_string(datagrams_per_wakeup),
+            " per wakeup, at most ", std::to_string(receive_totals.max_datagrams_per_wakeup)});
+    }
+
+    Output_writer::getStdout().writeLine({"Duration: ", std::to_string(seconds), " s"});
+}
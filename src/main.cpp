@@ -9,6 +9,10 @@
 
 #include "args.h"
 #include "client.h"
+#include "event-loop.h"
+#include "load-generator.h"
+#include "stdin-reader.h"
+#include "output-writer.h"
 #include "exception.h"
 #include "error.h"
 
@@ -34,11 +38,25 @@ int main(const int argc, char* argv[]) try
         return EXIT_SUCCESS;
     }
 
+    // Run the scripted load sessions instead of the interactive client
+    if(args.getSessionCount() != 0)
+    {
+        return Load_generator{args}.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // The loop is created first, it blocks SIGINT before any other thread is started
+    Event_loop event_loop{};
+
+    // Output of an iteration is written by a single system call before the loop waits
+    event_loop.setBeforeWaitHook([] { Output_writer::getStdout().flush(); });
+
     // Create and initialize the client using parsed arguments
-    const std::unique_ptr<Client> client{Client::create(args)};
+    event_loop.addSession(Client::create(args, event_loop, std::make_unique<Stdin_reader>(Client::s_STDIN_BUFFER_SIZE),
+                                         Chat_callbacks::createConsole(true)));
 
     // Start the client logic (e.g., connect to server, handle communication)
-    return client->run();
+    event_loop.run();
+    return event_loop.getStats().failed_session_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 catch (const std::bad_alloc& e) {
     // Handle memory allocation failures
@@ -47,11 +65,6 @@ catch (const std::bad_alloc& e) {
 }
 catch (const Exception& e) {
     // Gracefully handle known application-specific exceptions
-    if(e.isSigintOrEofReceived())
-    {
-        return EXIT_SUCCESS;
-    }
-
     printErrMsg(e.what());
     return EXIT_FAILURE;
 }
@@ -0,0 +1,56 @@
+/**
+ * @file outbound-msg.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the message to the server described by views of its parts.
+ */
+
+#include "outbound-msg.h"
+#include "exception.h"
+
+void Outbound_msg::assign(std::initializer_list<std::string_view> parts)
+{
+    m_part_count = 0;
+    m_size = 0;
+
+    for(const std::string_view part : parts)
+    {
+        if(part.empty())
+        {
+            continue;
+        }
+
+        if(m_part_count == s_MAX_PARTS)
+        {
+            throw Exception{"too many parts of a message to the server."};
+        }
+
+        m_parts[m_part_count++] = {const_cast<char*> (part.data()), part.size()};
+        m_size += part.size();
+    }
+}
+
+struct iovec* Outbound_msg::getIovecs()
+{
+    return m_parts.data();
+}
+
+std::size_t Outbound_msg::getPartCount() const
+{
+    return m_part_count;
+}
+
+std::size_t Outbound_msg::getSize() const
+{
+    return m_size;
+}
+
+void Outbound_msg::copyTo(std::string& destination) const
+{
+    destination.clear();
+    destination.reserve(m_size);
+
+    for(std::size_t i{0}; i < m_part_count; ++i)
+    {
+        destination.append(static_cast<const char*> (m_parts[i].iov_base), m_parts[i].iov_len);
+    }
+}
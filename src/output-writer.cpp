@@ -0,0 +1,127 @@
+/**
+ * @file output-writer.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the buffered writer of the client's output lines.
+ */
+
+#include "output-writer.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <sys/uio.h> // writev()
+#include <unistd.h>  // isatty(), STDOUT_FILENO
+
+namespace
+{
+    /**
+     * @brief Writes all data described by the iovec array, repeating writev() after partial writes.
+     *
+     * Output errors are ignored just like with std::cout (e.g. stdout closed by the reader), the rest of the data is dropped.
+     */
+    void writeAll(int file_descriptor, struct iovec* iovecs, int iovec_count)
+    {
+        while(iovec_count > 0)
+        {
+            ssize_t written_bytes{writev(file_descriptor, iovecs, iovec_count)};
+
+            if(written_bytes == -1)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+
+                return;
+            }
+
+            // skip fully written iovecs and shift the partially written one
+            while(iovec_count > 0 && static_cast<std::size_t> (written_bytes) >= iovecs->iov_len)
+            {
+                written_bytes -= static_cast<ssize_t> (iovecs->iov_len);
+                ++iovecs;
+                --iovec_count;
+            }
+
+            if(iovec_count > 0)
+            {
+                iovecs->iov_base = static_cast<char*> (iovecs->iov_base) + written_bytes;
+                iovecs->iov_len -= static_cast<std::size_t> (written_bytes);
+            }
+        }
+    }
+}
+
+Output_writer::Output_writer(int file_descriptor)
+    :
+    m_file_descriptor{file_descriptor},
+    m_is_line_buffered{isatty(file_descriptor) == 1}
+{
+    m_buffer.reserve(s_BUFFER_CAPACITY + s_LARGE_PART_SIZE);
+}
+
+Output_writer::~Output_writer()
+{
+    flush();
+}
+
+Output_writer& Output_writer::getStdout()
+{
+    // every thread of the load generator buffers its own lines, writev() keeps each flushed block whole
+    static thread_local Output_writer value{STDOUT_FILENO};
+    return value;
+}
+
+void Output_writer::writeLine(std::initializer_list<std::string_view> parts)
+{
+    // A line of more parts than writev() is given is copied to the buffer like a short one
+    if(parts.size() <= s_MAX_LINE_PARTS
+       && std::any_of(parts.begin(), parts.end(), [](std::string_view part) { return part.size() >= s_LARGE_PART_SIZE; }))
+    {
+        writeLineDirectly(parts);
+        return;
+    }
+
+    for(const std::string_view part : parts)
+    {
+        m_buffer.append(part);
+    }
+
+    m_buffer.push_back('\n');
+
+    if(m_is_line_buffered || m_buffer.size() >= s_BUFFER_CAPACITY)
+    {
+        flush();
+    }
+}
+
+void Output_writer::writeLineDirectly(std::initializer_list<std::string_view> parts)
+{
+    std::array<struct iovec, s_MAX_LINE_PARTS + 2> iovecs{};
+    int iovec_count{0};
+
+    iovecs[iovec_count++] = {m_buffer.data(), m_buffer.size()};
+
+    for(const std::string_view part : parts)
+    {
+        iovecs[iovec_count++] = {const_cast<char*> (part.data()), part.size()};
+    }
+
+    static const char line_feed{'\n'};
+    iovecs[iovec_count++] = {const_cast<char*> (&line_feed), sizeof(line_feed)};
+
+    writeAll(m_file_descriptor, iovecs.data(), iovec_count);
+    m_buffer.clear();
+}
+
+void Output_writer::flush()
+{
+    if(m_buffer.empty())
+    {
+        return;
+    }
+
+    struct iovec buffer_iovec{m_buffer.data(), m_buffer.size()};
+
+    writeAll(m_file_descriptor, &buffer_iovec, 1);
+    m_buffer.clear();
+}
@@ -0,0 +1,372 @@
+/**
+ * @file protocol-session.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the protocol core of a client session that performs no I/O.
+ */
+
+#include "protocol-session.h"
+#include "tcp-session.h"
+#include "udp-session.h"
+#include <algorithm>
+
+Protocol_session::Protocol_session(Clock::time_point now)
+    :
+    m_now{now},
+    m_timer_wheel{now}
+{
+    m_user_display_name.reserve(s_DISPLAY_NAME_MAX_LENGTH);
+}
+
+std::unique_ptr<Protocol_session> Protocol_session::create(bool is_tcp, const Session_config& config, Clock::time_point now)
+{
+    if(is_tcp)
+    {
+        return std::make_unique<Tcp_session>(now);
+    }
+
+    return std::make_unique<Udp_session>(config, now);
+}
+
+const Action_list& Protocol_session::processUserLine(std::string_view line, Clock::time_point now)
+{
+    if(!beginCall(now))
+    {
+        return endCall();
+    }
+
+    const User_input user_input{parseUserInput(line)};
+
+    if(user_input.type != User_input_type::U_INVALID && !processNonMsgToServer(user_input))
+    {
+        ++m_stats.sent_msg_count;
+        processUserInput(user_input);
+    }
+
+    return endCall();
+}
+
+const Action_list& Protocol_session::processUserEof(Clock::time_point now)
+{
+    if(beginCall(now))
+    {
+        processEof();
+    }
+
+    return endCall();
+}
+
+const Action_list& Protocol_session::processSigint(Clock::time_point now)
+{
+    if(beginCall(now))
+    {
+        processInterrupt();
+    }
+
+    return endCall();
+}
+
+const Action_list& Protocol_session::processTimers(Clock::time_point now)
+{
+    if(!beginCall(now))
+    {
+        return endCall();
+    }
+
+    m_expired_timers.clear();
+    m_timer_wheel.expire(now, m_expired_timers);
+
+    // An expired REPLY timeout terminates the session, so retransmissions expired at the same time aren't sent
+    std::stable_partition(m_expired_timers.begin(), m_expired_timers.end(),
+        [](Timer_name name) { return name.kind == Timer_kind::T_REPLY; });
+
+    // Processing one timer may stop the others (e.g. the ERR sent because of the REPLY timeout stops all
+    // retransmissions), so the handles of the whole batch are invalidated first
+    for(const Timer_name name : m_expired_timers)
+    {
+        forgetExpiredTimer(name);
+    }
+
+    for(const Timer_name name : m_expired_timers)
+    {
+        if(m_is_closed)
+        {
+            break;
+        }
+
+        processTimerEvent(name);
+    }
+
+    return endCall();
+}
+
+const Action_list& Protocol_session::processTransportError(const char* reason, Clock::time_point now)
+{
+    if(beginCall(now))
+    {
+        processTransportFailure(reason);
+    }
+
+    return endCall();
+}
+
+bool Protocol_session::isClosed() const
+{
+    return m_is_closed;
+}
+
+FSM_state Protocol_session::getState() const
+{
+    return m_current_state;
+}
+
+const Session_stats& Protocol_session::getStats() const
+{
+    return m_stats;
+}
+
+bool Protocol_session::beginCall(Clock::time_point now)
+{
+    m_actions.clear();
+    m_now = now;
+    return !m_is_closed;
+}
+
+const Action_list& Protocol_session::endCall()
+{
+    if(m_is_closed)
+    {
+        return m_actions;
+    }
+
+    // the caller arms a single timer to the earliest deadline, only its changes are reported
+    const std::optional<Clock::time_point> deadline{m_timer_wheel.getEarliestDeadline()};
+
+    if(deadline != m_reported_deadline)
+    {
+        addAction(Action_type::A_SET_TIMER).deadline = deadline;
+        m_reported_deadline = deadline;
+    }
+
+    return m_actions;
+}
+
+Protocol_session::Clock::time_point Protocol_session::getNow() const
+{
+    return m_now;
+}
+
+Timer_wheel::Timer_handle Protocol_session::startTimer(Timer_name name, std::chrono::milliseconds timeout)
+{
+    return m_timer_wheel.schedule(m_now + timeout, name);
+}
+
+void Protocol_session::stopTimer(Timer_wheel::Timer_handle& handle)
+{
+    m_timer_wheel.cancel(handle);
+}
+
+void Protocol_session::forgetExpiredTimer(Timer_name name)
+{
+    if(name.kind == Timer_kind::T_REPLY)
+    {
+        m_reply_timer = Timer_wheel::s_INVALID_HANDLE;
+    }
+}
+
+Protocol_action& Protocol_session::addAction(Action_type type)
+{
+    Protocol_action& action{m_actions.emplace_back()};
+    action.type = type;
+    return action;
+}
+
+void Protocol_session::addSendAction()
+{
+    addSendAction(m_msg_to_server);
+}
+
+void Protocol_session::addSendAction(const Outbound_msg& msg)
+{
+    addAction(Action_type::A_SEND).msg = msg;
+}
+
+void Protocol_session::addReceiveAction(Protocol_msg_type msg_type, std::string_view display_name,
+                                        std::string_view content, bool is_positive)
+{
+    Protocol_action& action{addAction(Action_type::A_RECEIVE)};
+    action.msg_type = msg_type;
+    action.display_name = display_name;
+    action.content = content;
+    action.is_success = is_positive;
+}
+
+void Protocol_session::addPrintErrorAction(std::string_view err_msg)
+{
+    addAction(Action_type::A_PRINT_ERROR).content = err_msg;
+}
+
+void Protocol_session::addFollowPeerAction()
+{
+    addAction(Action_type::A_FOLLOW_PEER);
+}
+
+void Protocol_session::addCloseAction(bool is_success, std::string_view reason)
+{
+    Protocol_action& action{addAction(Action_type::A_CLOSE)};
+    action.is_success = is_success;
+    action.reason = reason;
+    m_is_closed = true;
+}
+
+bool Protocol_session::isValidDisplayNameLength(unsigned display_name_length) const
+{
+    return display_name_length >= 1 && display_name_length << s_DISPLAY_NAME_MAX_LENGTH;
+}
+
+bool Protocol_session::isValidMsgContentLength(unsigned msg_content_length) const
+{
+    return msg_content_length >= 1 && msg_content_length <= s_MSG_CONTENT_MAX_LENGTH;
+}
+
+void Protocol_session::outputIncomingMsg(std::string_view display_name, std::string_view content)
+{
+    ++m_stats.received_msg_count;
+    addReceiveAction(Protocol_msg_type::M_MSG, display_name, content, false);
+}
+
+void Protocol_session::outputIncomingReply(bool is_positive, std::string_view content)
+{
+    ++(is_positive ? m_stats.positive_reply_count : m_stats.negative_reply_count);
+    addReceiveAction(Protocol_msg_type::M_REPLY, {}, content, is_positive);
+}
+
+void Protocol_session::printErrFromServer(std::string_view display_name, std::string_view message_content)
+{
+    ++m_stats.received_err_count;
+    addReceiveAction(Protocol_msg_type::M_ERR, display_name, message_content, false);
+}
+
+bool Protocol_session::processNonMsgToServer(const User_input& user_input)
+{
+    if(user_input.type == User_input_type::U_RENAME)
+    {
+        m_user_display_name = user_input.display_name;
+        return true;
+    }
+
+    if(user_input.type == User_input_type::U_HELP)
+    {
+        addAction(Action_type::A_PRINT).content = {"Supported commands:\n/auth {Username} {Secret} {DisplayName} - client authentication (signing in)"
+                 " using user-provided username, display name and a password\n/join {ChannelID} - client's request to"
+                 " join a chat channel by its identifier\n/rename {DisplayName} - locally changes the display name of"
+                 " the user to be sent with new messages/selected commands\n/help - prints out supported local commands"
+                 " with their parameters and a description"};
+        return true;
+    }
+
+    return false;
+}
+
+bool Protocol_session::buildUserMsgToServer(const User_input& user_input)
+{
+    switch(user_input.type)
+    {
+        case User_input_type::U_AUTH:
+            buildAuthMsg(user_input.username, user_input.secret);
+            return true;
+        case User_input_type::U_JOIN:
+            buildJoinMsg(user_input.channel_id);
+            return true;
+        case User_input_type::U_MSG:
+            buildMsgMsg(user_input.content);
+            return true;
+        default:
+            addCloseAction(false, "function buildUserMsgToServer() is expected to be called when user enters an auth"
+                                  " command or join command or a message.");
+            return false;
+    }
+}
+
+User_input Protocol_session::parseUserInput(std::string_view line)
+{
+    const User_input user_input{User_input_parser::parse(line)};
+
+    switch(user_input.type)
+    {
+        case User_input_type::U_AUTH:
+            if(!canSendMessageType(Protocol_msg_type::M_AUTH))
+            {
+                addPrintErrorAction("you can't send this type of message in the current client state.");
+                return {};
+            }
+
+            if(user_input.username.length() > s_USERNAME_MAX_LENGTH || user_input.secret.length() > s_USER_SECRET_MAX_LENGTH
+               || !isValidDisplayNameLength(user_input.display_name.length()))
+            {
+                addPrintErrorAction("invalid length of the message parameter.");
+                return {};
+            }
+            break;
+
+        case User_input_type::U_JOIN:
+            if(!canSendMessageType(Protocol_msg_type::M_JOIN))
+            {
+                addPrintErrorAction("you can't send this type of message in the current client state.");
+                return {};
+            }
+
+            if(user_input.channel_id.length() > s_CHANEL_ID_MAX_LENGTH)
+            {
+                addPrintErrorAction("invalid length of the message parameter.");
+                return {};
+            }
+            break;
+
+        case User_input_type::U_RENAME:
+            if(m_current_state == FSM_state::S_JOIN) // assertion
+            {
+                addPrintErrorAction("you can't rename yourself in the current application state.");
+                return {};
+            }
+
+            if(!isValidDisplayNameLength(user_input.display_name.length()))
+            {
+                addPrintErrorAction("invalid length of the message parameter.");
+                return {};
+            }
+            break;
+
+        case User_input_type::U_HELP:
+            break;
+
+        case User_input_type::U_MSG:
+            if(!canSendMessageType(Protocol_msg_type::M_MSG))
+            {
+                addPrintErrorAction("you can't send this type of message in the current client state.");
+                return {};
+            }
+
+            if(!isValidMsgContentLength(user_input.content.length()))
+            {
+                addPrintErrorAction("invalid length of the message parameter.");
+                return {};
+            }
+            break;
+
+        default:
+            addPrintErrorAction("invalid user input.");
+            return {};
+    }
+
+    return user_input;
+}
+
+bool Protocol_session::canSendMessageType(Protocol_msg_type msg_type) const
+{
+    if(msg_type == Protocol_msg_type::M_AUTH)
+    {
+        return m_current_state == FSM_state::S_START || m_current_state == FSM_state::S_AUTH;
+    }
+
+    return m_current_state == FSM_state::S_OPEN;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file replay-window.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the sliding window of received server MessageIDs.
+ */
+
+#include "replay-window.h"
+
+int32_t Replay_window::getAge(uint16_t msg_id) const
+{
+    // serial number arithmetic: the difference is interpreted modulo 2^16 as a signed number
+    return static_cast<int16_t> (static_cast<uint16_t> (m_highest_msg_id - msg_id));
+}
+
+bool Replay_window::contains(uint16_t msg_id) const
+{
+    if(m_is_empty)
+    {
+        return false;
+    }
+
+    const int32_t age{getAge(msg_id)};
+
+    if(age < 0 || age >= s_WINDOW_SIZE)
+    {
+        return false;
+    }
+
+    return (m_seen[(msg_id % s_WINDOW_SIZE) / s_BITS_IN_WORD] >> (msg_id % s_BITS_IN_WORD)) & 1;
+}
+
+void Replay_window::insert(uint16_t msg_id)
+{
+    if(m_is_empty)
+    {
+        m_is_empty = false;
+        m_highest_msg_id = msg_id;
+        setBit(msg_id);
+        return;
+    }
+
+    const int32_t age{getAge(msg_id)};
+
+    if(age >= s_WINDOW_SIZE)
+    {
+        return;
+    }
+
+    if(age < 0)
+    {
+        // slide forward, forgetting the MessageIDs that fall out of the window
+        if(-age >= s_WINDOW_SIZE)
+        {
+            m_seen.fill(0);
+        }
+        else
+        {
+            for(int32_t i{1}; i <= -age; ++i)
+            {
+                clearBit(static_cast<uint16_t> (m_highest_msg_id + i));
+            }
+        }
+
+        m_highest_msg_id = msg_id;
+    }
+
+    setBit(msg_id);
+}
+
+void Replay_window::setBit(uint16_t msg_id)
+{
+    m_seen[(msg_id % s_WINDOW_SIZE) / s_BITS_IN_WORD] |= uint64_t{1} << (msg_id % s_BITS_IN_WORD);
+}
+
+void Replay_window::clearBit(uint16_t msg_id)
+{
+    m_seen[(msg_id % s_WINDOW_SIZE) / s_BITS_IN_WORD] &= ~(uint64_t{1} << (msg_id % s_BITS_IN_WORD));
+}
@@ -0,0 +1,86 @@
+/**
+ * @file retransmission-queue.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the queue of unconfirmed UDP client messages.
+ */
+
+#include "retransmission-queue.h"
+#include "exception.h"
+#include <algorithm>
+#include <utility>
+
+Retransmission_queue::Retransmission_queue(std::size_t window_size)
+    :
+    m_pending_msgs(window_size)
+{
+}
+
+bool Retransmission_queue::isFull() const
+{
+    return m_size >= m_pending_msgs.size();
+}
+
+bool Retransmission_queue::isEmpty() const
+{
+    return m_size == 0;
+}
+
+std::size_t Retransmission_queue::getSize() const
+{
+    return m_size;
+}
+
+Pending_msg& Retransmission_queue::push()
+{
+    if(isFull())
+    {
+        throw Exception{"function push() is expected to be called when the retransmission queue isn't full."};
+    }
+
+    return m_pending_msgs[m_size++];
+}
+
+const Pending_msg* Retransmission_queue::retire(uint16_t msg_id)
+{
+    const auto it{std::find_if(begin(), end(),
+        [msg_id](const Pending_msg& pending_msg) { return pending_msg.msg_id == msg_id; })};
+
+    if(it == end())
+    {
+        return nullptr;
+    }
+
+    // swapping keeps both message buffers allocated
+    --m_size;
+    std::swap(*it, m_pending_msgs[m_size]);
+    return &m_pending_msgs[m_size];
+}
+
+bool Retransmission_queue::contains(uint16_t msg_id) const
+{
+    return std::any_of(m_pending_msgs.begin(), m_pending_msgs.begin() + static_cast<std::ptrdiff_t> (m_size),
+        [msg_id](const Pending_msg& pending_msg) { return pending_msg.msg_id == msg_id; });
+}
+
+Pending_msg* Retransmission_queue::find(uint16_t msg_id)
+{
+    const auto it{std::find_if(begin(), end(),
+        [msg_id](const Pending_msg& pending_msg) { return pending_msg.msg_id == msg_id; })};
+
+    return it == end() ? nullptr : &*it;
+}
+
+void Retransmission_queue::clear()
+{
+    m_size = 0;
+}
+
+std::vector<Pending_msg>::iterator Retransmission_queue::begin()
+{
+    return m_pending_msgs.begin();
+}
+
+std::vector<Pending_msg>::iterator Retransmission_queue::end()
+{
+    return m_pending_msgs.begin() + static_cast<std::ptrdiff_t> (m_size);
+}
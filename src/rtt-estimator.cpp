@@ -0,0 +1,55 @@
+/**
+ * @file rtt-estimator.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the RFC 6298 retransmission timeout estimator.
+ */
+
+#include "rtt-estimator.h"
+#include <algorithm>
+
+Rtt_estimator::Rtt_estimator(std::chrono::milliseconds initial_rto, std::chrono::milliseconds min_rto,
+                             std::chrono::milliseconds max_rto)
+    :
+    m_rto{initial_rto},
+    m_min_rto{min_rto},
+    m_max_rto{max_rto}
+{
+    clampRto();
+}
+
+void Rtt_estimator::addSample(std::chrono::steady_clock::duration rtt)
+{
+    const Microseconds sample{std::chrono::duration_cast<Microseconds>(rtt)};
+
+    if(!m_srtt)
+    {
+        m_srtt = sample;
+        m_rttvar = sample / 2;
+    }
+    else
+    {
+        // alpha = 1/8, beta = 1/4; RTTVAR has to be updated with the old SRTT
+        const Microseconds deviation{*m_srtt > sample ? *m_srtt - sample : sample - *m_srtt};
+        m_rttvar = (3 * m_rttvar + deviation) / 4;
+        m_srtt = (7 * *m_srtt + sample) / 8;
+    }
+
+    m_rto = *m_srtt + std::max(s_CLOCK_GRANULARITY, 4 * m_rttvar);
+    clampRto();
+}
+
+void Rtt_estimator::backOff()
+{
+    m_rto *= 2;
+    clampRto();
+}
+
+std::chrono::milliseconds Rtt_estimator::getRto() const
+{
+    return std::chrono::ceil<std::chrono::milliseconds>(m_rto);
+}
+
+void Rtt_estimator::clampRto()
+{
+    m_rto = std::clamp(m_rto, m_min_rto, m_max_rto);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file script-reader.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the scripted user input of a session of the load generator.
+ */
+
+#include "script-reader.h"
+#include <algorithm>
+
+Script_reader::Script_reader(std::shared_ptr<const std::vector<std::string>> script, unsigned session_number,
+                             std::chrono::milliseconds think_time, std::chrono::microseconds msg_interval)
+    :
+    m_script{std::move(script)},
+    m_session_number{std::to_string(session_number)},
+    m_think_time{think_time},
+    m_msg_interval{msg_interval}
+{
+}
+
+int Script_reader::getFileDescriptor() const
+{
+    return -1;
+}
+
+bool Script_reader::read()
+{
+    return true;
+}
+
+Input_source::Line_status Script_reader::nextLine(std::string_view& line)
+{
+    if(m_is_eof)
+    {
+        return Line_status::L_NONE;
+    }
+
+    const Clock::time_point now{Clock::now()};
+    const bool is_end{m_next_line == m_script->size()};
+
+    // the pause starts when the session is ready for the next line
+    if(!m_next_line_time)
+    {
+        m_next_line_time = now + m_think_time;
+
+        if(!is_end && !(*m_script)[m_next_line].starts_with('/') && m_last_msg_time)
+        {
+            m_next_line_time = std::max(*m_next_line_time, *m_last_msg_time + m_msg_interval);
+        }
+    }
+
+    if(now < *m_next_line_time)
+    {
+        return Line_status::L_NONE;
+    }
+
+    m_next_line_time.reset();
+
+    if(is_end)
+    {
+        m_is_eof = true;
+        return Line_status::L_NONE;
+    }
+
+    const std::string& script_line{(*m_script)[m_next_line++]};
+
+    if(!script_line.starts_with('/'))
+    {
+        m_last_msg_time = now;
+    }
+
+    substitute(script_line);
+    line = m_line;
+    return Line_status::L_LINE;
+}
+
+bool Script_reader::isFull() const
+{
+    return false;
+}
+
+bool Script_reader::isEofRead() const
+{
+    return true;
+}
+
+bool Script_reader::isEof() const
+{
+    return m_is_eof;
+}
+
+std::optional<Input_source::Clock::time_point> Script_reader::getNextLineTime() const
+{
+    return m_next_line_time;
+}
+
+void Script_reader::substitute(const std::string& script_line)
+{
+    m_line.clear();
+    std::size_t position{0};
+
+    for(std::size_t placeholder{script_line.find(s_SESSION_PLACEHOLDER)}; placeholder != std::string::npos;
+        placeholder = script_line.find(s_SESSION_PLACEHOLDER, position))
+    {
+        m_line.append(script_line, position, placeholder - position);
+        m_line.append(m_session_number);
+        position = placeholder + s_SESSION_PLACEHOLDER.size();
+    }
+
+    m_line.append(script_line, position);
+}
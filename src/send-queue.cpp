@@ -0,0 +1,104 @@
+/**
+ * @file send-queue.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the outbound byte queue of a non-blocking stream socket.
+ */
+
+#include "send-queue.h"
+#include <cerrno>
+#include <sys/socket.h> // sendmsg()
+
+bool Send_queue::send(int socket, struct iovec* iovecs, std::size_t iovec_count)
+{
+    std::size_t sent_bytes{0};
+
+    if(isEmpty() && !sendParts(socket, iovecs, iovec_count, sent_bytes))
+    {
+        return false;
+    }
+
+    // queue the unsent rest, skipping the parts sent completely
+    for(std::size_t i{0}; i < iovec_count; ++i)
+    {
+        if(sent_bytes >= iovecs[i].iov_len)
+        {
+            sent_bytes -= iovecs[i].iov_len;
+            continue;
+        }
+
+        m_data.append(static_cast<const char*> (iovecs[i].iov_base) + sent_bytes, iovecs[i].iov_len - sent_bytes);
+        sent_bytes = 0;
+    }
+
+    return true;
+}
+
+bool Send_queue::flush(int socket)
+{
+    while(!isEmpty())
+    {
+        struct iovec data{m_data.data() + m_begin, m_data.size() - m_begin};
+        std::size_t sent_bytes{0};
+
+        if(!sendParts(socket, &data, 1, sent_bytes))
+        {
+            return false;
+        }
+
+        if(sent_bytes == 0)
+        {
+            break;
+        }
+
+        m_begin += sent_bytes;
+    }
+
+    // the storage is reused, data is moved to the front only when everything has been sent
+    if(isEmpty())
+    {
+        m_data.clear();
+        m_begin = 0;
+    }
+
+    return true;
+}
+
+bool Send_queue::isEmpty() const
+{
+    return m_begin == m_data.size();
+}
+
+std::size_t Send_queue::getSize() const
+{
+    return m_data.size() - m_begin;
+}
+
+bool Send_queue::sendParts(int socket, struct iovec* iovecs, std::size_t iovec_count, std::size_t& sent_bytes)
+{
+    struct msghdr msg_header{};
+    msg_header.msg_iov = iovecs;
+    msg_header.msg_iovlen = iovec_count;
+    sent_bytes = 0;
+
+    while(true)
+    {
+        // a closed connection is reported by EPIPE instead of SIGPIPE, which would kill every session of the process
+        const ssize_t result{sendmsg(socket, &msg_header, MSG_NOSIGNAL)};
+
+        if(result >= 0)
+        {
+            sent_bytes = static_cast<std::size_t> (result);
+            return true;
+        }
+
+        if(errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return true;
+        }
+
+        if(errno != EINTR)
+        {
+            return false;
+        }
+    }
+}
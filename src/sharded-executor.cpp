@@ -0,0 +1,203 @@
+/**
+ * @file sharded-executor.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of running client sessions on one event loop per CPU.
+ */
+
+#include "sharded-executor.h"
+#include "client.h"
+#include "error.h"
+#include "exception.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <poll.h>         // poll()
+#include <pthread.h>      // pthread_setaffinity_np()
+#include <sched.h>        // sched_getaffinity(), cpu_set_t
+#include <sys/eventfd.h>  // eventfd()
+#include <sys/signalfd.h> // struct signalfd_siginfo
+#include <thread>
+#include <unistd.h>       // read(), write(), close()
+
+Sharded_executor::Sharded_executor(uint32_t session_count)
+    :
+    m_session_count{session_count}
+{
+    const std::vector<int> cpus{getAllowedCpus()};
+    const std::size_t loop_count{std::min<std::size_t>(cpus.size(), std::max<uint32_t>(session_count, 1))};
+
+    m_shards.resize(loop_count);
+
+    for(std::size_t i{0}; i < loop_count; ++i)
+    {
+        m_shards[i].cpu = cpus[i];
+        m_shards[i].loop = std::make_unique<Event_loop>(false);
+    }
+}
+
+std::size_t Sharded_executor::getLoopCount() const
+{
+    return m_shards.size();
+}
+
+Loop_stats Sharded_executor::run(const Session_factory& create_session)
+{
+    // Blocked before the workers are started, so neither they nor their resolver threads receive SIGINT
+    const int signal_fd{Event_loop::createSigintFd()};
+    const int done_fd{eventfd(0, 0)};
+
+    if(done_fd < 0)
+    {
+        close(signal_fd);
+        throw Exception{"couldn't create an event file descriptor: eventfd() has failed."};
+    }
+
+    {
+        // std::jthread joins in its destructor, even if starting a later worker has failed
+        std::vector<std::jthread> workers{};
+        workers.reserve(m_shards.size());
+
+        for(std::size_t i{0}; i < m_shards.size(); ++i)
+        {
+            workers.emplace_back(&Sharded_executor::runShard, this, i, std::cref(create_session), done_fd);
+        }
+
+        waitForShards(signal_fd, done_fd);
+    }
+
+    close(done_fd);
+    close(signal_fd);
+
+    // The workers have been joined, so their statistics are read without any synchronization
+    Loop_stats stats{};
+
+    for(const Shard& shard : m_shards)
+    {
+        stats += shard.stats;
+    }
+
+    return stats;
+}
+
+void Sharded_executor::runShard(std::size_t shard_index, const Session_factory& create_session, int done_fd)
+{
+    Shard& shard{m_shards[shard_index]};
+    Event_loop& loop{*shard.loop};
+
+    cpu_set_t cpu_set{};
+    CPU_ZERO(&cpu_set);
+    CPU_SET(shard.cpu, &cpu_set);
+
+    // Pinning is only an optimization, an unpinned worker works the same
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+
+    Loop_stats failed_creations{};
+
+    for(uint32_t session_number{0}; session_number < m_session_count; ++session_number)
+    {
+        if(getShardIndex(session_number) != shard_index)
+        {
+            continue;
+        }
+
+        try
+        {
+            loop.addSession(create_session(loop, session_number));
+        }
+        // not only Exception: std::bad_alloc or std::system_error may escape the session factory
+        catch(const std::exception& e)
+        {
+            printErrMsg(e.what());
+            ++failed_creations.failed_session_count;
+        }
+    }
+
+    try
+    {
+        loop.run();
+    }
+    // an exception escaping the worker would terminate the client, and waitForShards() would never be woken up
+    catch(const std::exception& e)
+    {
+        printErrMsg(e.what());
+    }
+
+    shard.stats = loop.getStats();
+    shard.stats += failed_creations;
+
+    // The loop (and its remaining sessions) is destroyed by the executor, after the worker has been joined
+    const uint64_t done_count{1};
+    [[maybe_unused]] const ssize_t written_bytes{write(done_fd, &done_count, sizeof(done_count))};
+}
+
+void Sharded_executor::waitForShards(int signal_fd, int done_fd)
+{
+    std::array<struct pollfd, 2> poll_fds{{{.fd = signal_fd, .events = POLLIN, .revents = 0},
+                                           {.fd = done_fd, .events = POLLIN, .revents = 0}}};
+    uint64_t done_count{0};
+
+    while(done_count < m_shards.size())
+    {
+        if(poll(poll_fds.data(), poll_fds.size(), -1) == -1)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            throw Exception{"poll() has failed."};
+        }
+
+        if(poll_fds[0].revents != 0)
+        {
+            struct signalfd_siginfo signal_info{};
+
+            if(read(signal_fd, &signal_info, sizeof(signal_info)) == sizeof(signal_info))
+            {
+                for(Shard& shard : m_shards)
+                {
+                    shard.loop->interrupt();
+                }
+            }
+        }
+
+        if(poll_fds[1].revents != 0)
+        {
+            uint64_t completion_count{};
+
+            if(read(done_fd, &completion_count, sizeof(completion_count)) == sizeof(completion_count))
+            {
+                done_count += completion_count;
+            }
+        }
+    }
+}
+
+std::vector<int> Sharded_executor::getAllowedCpus()
+{
+    cpu_set_t cpu_set{};
+    std::vector<int> cpus{};
+
+    if(sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+    {
+        for(int cpu{0}; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if(CPU_ISSET(cpu, &cpu_set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+
+    if(cpus.empty())
+    {
+        cpus.push_back(0);
+    }
+
+    return cpus;
+}
+
+std::size_t Sharded_executor::getShardIndex(uint32_t session_number) const
+{
+    return std::hash<uint32_t>{}(session_number) % m_shards.size();
+}
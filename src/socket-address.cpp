@@ -0,0 +1,22 @@
+/**
+ * @file socket-address.cpp
+ * @author Andrii Klymenko
+ * @brief Definition of utility functions for IPv4 and IPv6 socket addresses.
+ */
+
+#include "socket-address.h"
+#include "exception.h"
+#include <netinet/in.h> // struct sockaddr_in, struct sockaddr_in6
+
+socklen_t getSocketAddressLength(const struct sockaddr_storage& address)
+{
+    switch(address.ss_family)
+    {
+        case AF_INET:
+            return sizeof(struct sockaddr_in);
+        case AF_INET6:
+            return sizeof(struct sockaddr_in6);
+        default:
+            throw Exception{"unsupported address family of the server address."};
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * @file stdin-reader.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the non-blocking reader of the standard input.
+ */
+
+#include "stdin-reader.h"
+#include "exception.h"
+#include <cerrno>
+#include <cstring> // std::memmove(), std::memchr()
+#include <fcntl.h>  // fcntl()
+#include <unistd.h> // read(), STDIN_FILENO
+
+Stdin_reader::Stdin_reader(std::size_t capacity)
+    :
+    m_data{std::make_unique_for_overwrite<char[]>(capacity)},
+    m_capacity{capacity},
+    m_original_flags{fcntl(STDIN_FILENO, F_GETFL)}
+{
+    if(m_original_flags == -1 || fcntl(STDIN_FILENO, F_SETFL, m_original_flags | O_NONBLOCK) == -1)
+    {
+        throw Exception{"couldn't switch stdin to non-blocking mode: fcntl() has failed."};
+    }
+}
+
+Stdin_reader::~Stdin_reader()
+{
+    // the file description may be shared with the shell (e.g. a terminal)
+    fcntl(STDIN_FILENO, F_SETFL, m_original_flags);
+}
+
+int Stdin_reader::getFileDescriptor() const
+{
+    return STDIN_FILENO;
+}
+
+bool Stdin_reader::read()
+{
+    // make room at the end by moving the unprocessed input to the front
+    if(m_begin != 0)
+    {
+        std::memmove(m_data.get(), m_data.get() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_scan -= m_begin;
+        m_begin = 0;
+    }
+
+    while(!m_is_eof_read && m_end < m_capacity)
+    {
+        const ssize_t read_bytes{::read(STDIN_FILENO, m_data.get() + m_end, m_capacity - m_end)};
+
+        if(read_bytes > 0)
+        {
+            m_end += static_cast<std::size_t> (read_bytes);
+        }
+        else if(read_bytes == 0)
+        {
+            m_is_eof_read = true;
+        }
+        else if(errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return true;
+        }
+        else if(errno != EINTR)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Stdin_reader::Line_status Stdin_reader::nextLine(std::string_view& line)
+{
+    while(true)
+    {
+        const char* line_feed{static_cast<const char*> (std::memchr(m_data.get() + m_scan, '\n', m_end - m_scan))};
+
+        if(line_feed == nullptr)
+        {
+            m_scan = m_end;
+
+            if(m_is_discarding)
+            {
+                m_begin = m_scan = m_end = 0;
+                m_is_discarding = !m_is_eof_read;
+                return Line_status::L_NONE;
+            }
+
+            if(m_end - m_begin == m_capacity)
+            {
+                // the line doesn't fit into the buffer, its rest is skipped by the following calls
+                m_begin = m_scan = m_end = 0;
+                m_is_discarding = !m_is_eof_read;
+                return Line_status::L_TOO_LONG;
+            }
+
+            if(m_is_eof_read && m_begin != m_end)
+            {
+                line = {m_data.get() + m_begin, m_end - m_begin};
+                m_begin = m_end;
+                return Line_status::L_LINE;
+            }
+
+            return Line_status::L_NONE;
+        }
+
+        const std::size_t line_feed_position{static_cast<std::size_t> (line_feed - m_data.get())};
+
+        if(m_is_discarding)
+        {
+            m_is_discarding = false;
+            m_begin = m_scan = line_feed_position + 1;
+            continue;
+        }
+
+        line = {m_data.get() + m_begin, line_feed_position - m_begin};
+        m_begin = m_scan = line_feed_position + 1;
+        return Line_status::L_LINE;
+    }
+}
+
+bool Stdin_reader::isFull() const
+{
+    return m_end - m_begin == m_capacity;
+}
+
+bool Stdin_reader::isEofRead() const
+{
+    return m_is_eof_read;
+}
+
+bool Stdin_reader::isEof() const
+{
+    return m_is_eof_read && m_begin == m_end;
+}
@@ -5,363 +5,200 @@
  */
 
 #include "tcp-client.h"
-#include "exception.h"
 #include "error.h"
-#include <iostream>
-#include <csignal>
+#include <cerrno>
 
-Tcp_client::Tcp_client(const Args& args)
+Tcp_client::Tcp_client(const Args& args, Event_loop& event_loop, std::shared_ptr<Input_source> input_source,
+                       Chat_callbacks callbacks)
     :
-    Client::Client{args}
+    Client::Client{args, event_loop, std::move(input_source), std::move(callbacks)},
+    m_session{Timer_wheel::Clock::now()},
+    m_connector{m_event_loop, *this}
 {
-    if(connect(m_client_socket, reinterpret_cast<struct sockaddr*>(m_args.getServerAddrStructAddress()), sizeof(*(m_args.getServerAddrStructAddress()))) < 0)
-    {
-        throw Exception{"couldn't connect to the server."};
-    }
+    // User input is queued until the connection is established by the client loop; the deadline includes the resolution
+    m_connect_deadline_timer = startTimer({Timer_kind::T_CONNECT_DEADLINE},
+        std::chrono::milliseconds{m_args.getTcpConnectTimeout()});
 }
 
-void Tcp_client::processStdinEvent()
+Protocol_session& Tcp_client::getSession()
 {
-    // Check if stdin was closed
-    if(m_actual_event.events & EPOLLHUP)
-    {
-        sendByeMsgToServer();
-        throw Exception{""};
-    }
-
-    if(m_actual_event.events & EPOLLERR)
-    {
-        throw Exception{"stdin error occurred."};
-    }
-
-    // Handle stdin event
-    std::vector<std::string> user_input{parseUserInput()};
+    return m_session;
+}
 
-    if(user_input.empty() || processNonMsgToServer(user_input))
-    {
-        return; // Skip empty input
-    }
+Session_outcome Tcp_client::processServerAddrsResolved()
+{
+    m_connector.setServerAddrs(m_args.getServerAddrs());
+    return startNextConnectionAttempt();
+}
 
-    if(user_input[0] == m_user_commands[0])
-    {
-        m_user_display_name = user_input[3];
-    }
+bool Tcp_client::isConnected() const
+{
+    return m_client_socket != -1;
+}
 
-    if(user_input[0] == m_user_commands[2])
+Session_outcome Tcp_client::startNextConnectionAttempt()
+{
+    if(!m_connector.startNextAttempt() && !m_connector.hasPendingAttempts())
     {
-        m_current_state = FSM_state::S_JOIN;
+        return Session_outcome::fail("couldn't connect to the server.");
     }
 
-    buildUserMsgToServer(user_input);
-    sendMsgToServer();
-
-    if(user_input[0] == m_user_commands[0] && m_current_state == FSM_state::S_START)
+    if(m_connector.hasAddressesLeft())
     {
-        m_current_state = FSM_state::S_AUTH;
+        m_connect_attempt_timer = startTimer({Timer_kind::T_CONNECT_ATTEMPT}, s_CONNECTION_ATTEMPT_DELAY);
     }
 
-    if(user_input[0] == m_user_commands[0] || user_input[0] == m_user_commands[2])
-    {
-        disableStdinEvents();
-        startTimer(s_MAX_REPLY_WAIT_TIME * 1000); // Time in ms
-        m_is_waiting_for_reply = true;
-    }
+    return Session_outcome::proceed();
 }
 
-void Tcp_client::processServerReplyMsg(const std::string& reply_msg_from_server)
+Session_outcome Tcp_client::processConnectEvent(int socket, uint32_t events)
 {
-    if(m_current_state != FSM_state::S_AUTH && m_current_state != FSM_state::S_JOIN)
-    {
-        sendErrMsgAndTerminate("received a REPLY message in unexpected state.");
-        return;
-    }
+    const int connected_socket{m_connector.processEvent(socket, events)};
 
-    if(m_is_waiting_for_reply)
+    if(connected_socket == -1)
     {
-        std::smatch matches{};
-        if(std::regex_match(reply_msg_from_server, matches, getReplyMsgRegex()) && isValidMsgContentLength(matches[2].length()))
+        // A failed attempt is replaced at once instead of after the delay
+        if(!m_connector.hasPendingAttempts())
         {
-            stopTimer();
-            bool is_positive_reply{strcasecmp(matches[1].str().c_str(), "OK") == 0};
-            outputIncomingReply(is_positive_reply, matches[2]);
-            if(m_current_state == FSM_state::S_JOIN || is_positive_reply)
-            {
-                m_current_state = FSM_state::S_OPEN;
-            }
-            m_is_waiting_for_reply = false;
-            enableStdinEvents();
-            return;
+            stopTimer(m_connect_attempt_timer);
+            return startNextConnectionAttempt();
         }
-
-        sendErrMsgAndTerminate("received a malformed REPLY message from the server.");
+        return Session_outcome::proceed();
     }
 
-    sendErrMsgAndTerminate("didn't expect any reply message from the server.");
-}
+    stopTimer(m_connect_attempt_timer);
+    stopTimer(m_connect_deadline_timer);
 
+    m_client_socket = connected_socket;
+    m_event_loop.add(m_client_socket, EPOLLIN, *this);
+    return Session_outcome::proceed();
+}
 
-uint8_t Tcp_client::processMessageFromServer(const std::string& msg_from_server)
+Session_outcome Tcp_client::processSocketEvent(uint32_t events)
 {
-    Protocol_msg_type type_of_msg_from_server{getServerMsgType(m_msg_from_server)};
-
-    if(type_of_msg_from_server == Protocol_msg_type::M_UNKNOWN)
+    // The rest of the queue is dropped if the connection fails
+    if(isClosing())
     {
-        sendErrMsgAndTerminate("only messages of types BYE, ERR, MSG and REPLY are expected to be received"
-                        " from the server.");
-    }
+        if((events & EPOLLOUT) && m_send_queue.flush(m_client_socket) && !m_send_queue.isEmpty())
+        {
+            return Session_outcome::proceed();
+        }
 
-    if(type_of_msg_from_server == Protocol_msg_type::M_BYE)
-    {
-        processServerByeMsg(msg_from_server);
-        return 0;
+        return getClosingOutcome();
     }
 
-    if(type_of_msg_from_server == Protocol_msg_type::M_ERR)
+    if(events & EPOLLERR)
     {
-        processServerErrMsg(msg_from_server);
-        return 1;
+        return executeActions(m_session.processTransportError("an error occurred on the client socket.",
+            Timer_wheel::Clock::now()));
     }
 
-    switch(m_current_state)
+    if(events & EPOLLOUT)
     {
-        case FSM_state::S_START:
-            sendErrMsgAndTerminate("only messages of types BYE and ERR are expected to be received"
-                        " from the server in the client's START state.");
-            break;
-
-        case FSM_state::S_AUTH:
-            if(type_of_msg_from_server == Protocol_msg_type::M_REPLY)
-            {
-                processServerReplyMsg(msg_from_server);
-                break;
-            }
-
-            sendErrMsgAndTerminate("only messages of types BYE, ERR and REPLY are expected to be received"
-                " from the server in the client's AUTH state.");
-            break;
-
-        case FSM_state::S_OPEN:
-            if(type_of_msg_from_server == Protocol_msg_type::M_MSG)
-            {
-                processServerMsgMsg(msg_from_server);
-            }
-            else
-            {
-                sendErrMsgAndTerminate("only messages of types BYE, ERR and MSG are expected to be received"
-                    " from the server in the client's OPEN state.");
-            }
-            break;
-
-        case FSM_state::S_JOIN:
-            switch(type_of_msg_from_server)
-            {
-                case Protocol_msg_type::M_REPLY:
-                    processServerReplyMsg(msg_from_server);
-                    break;
-
-                case Protocol_msg_type::M_MSG:
-                    processServerMsgMsg(msg_from_server);
-                    break;
-
-                default:
-                    sendErrMsgAndTerminate("only messages of types BYE, ERR, MSG and REPLY are expected to be received"
-                        " from the server in the client's JOIN state.");
-            }
-            break;
-
-        default:
-            throw Exception{"Invalid client's FSM state."};
-    }
-
-    return 2;
-}
-
-// this function was generated by AI
-uint8_t Tcp_client::processSocketEvent()
-{
-    const long server_msg_length{recv(m_client_socket, m_server_msg.get(), s_MAX_MSG_SIZE + 1, 0)};
+        if(!m_send_queue.flush(m_client_socket))
+        {
+            setSendQueueError();
+            return processSendError();
+        }
 
-    if(server_msg_length < 0)
-    {
-        sendErrMsgAndTerminate("couldn't receive a message from the server: recv() has failed.");
+        updateSocketEvents();
     }
 
-    if(server_msg_length == 0) // Connection closed by the server
+    if(!(events & (EPOLLIN | EPOLLHUP)))
     {
-        return 0;
+        return Session_outcome::proceed();
     }
 
-    // Append received data to the buffer
-    m_msg_from_server += std::string{m_server_msg.get(), static_cast<size_t>(server_msg_length)};
-    size_t end_of_msg_position;
+    // The bytes are received straight into the buffer of the session
+    const long server_msg_length{recv(m_client_socket, m_session.getReceiveSpace(), m_session.getReceiveSpaceSize(), 0)};
 
-    // Keep processing as long as we have complete messages
-    while((end_of_msg_position = m_msg_from_server.find(s_END_OF_MESSAGE)) != std::string::npos)
+    if(server_msg_length < 0)
     {
-        std::string single_msg = m_msg_from_server.substr(0, end_of_msg_position + s_BYTES_IN_END_OF_MESSAGE);
-
-        // Validate length
-        if(single_msg.size() > s_MAX_MSG_SIZE)
+        if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
         {
-            sendErrMsgAndTerminate("too long message from server.");
+            return Session_outcome::proceed();
         }
 
-        // Process the single complete message
-        uint8_t result{processMessageFromServer(single_msg)};
-
-        if(result == 0 || result == 1)
-        {
-            return result;
-        }
-
-        // Remove processed message from the buffer
-        m_msg_from_server.erase(0, end_of_msg_position + s_BYTES_IN_END_OF_MESSAGE);
+        return executeActions(m_session.processTransportError(
+            "couldn't receive a message from the server: recv() has failed.", Timer_wheel::Clock::now()));
     }
 
-    // Validate length
-    if(m_msg_from_server.size() >= s_MAX_MSG_SIZE)
+    if(server_msg_length == 0) // Connection closed by the server
     {
-        sendErrMsgAndTerminate("too long message from server.");
+        return executeActions(m_session.processStreamEnd(Timer_wheel::Clock::now()));
     }
 
-    return 2;
+    return executeActions(m_session.processReceived(static_cast<std::size_t> (server_msg_length), Timer_wheel::Clock::now()));
 }
 
-void Tcp_client::sigintHandler()
+Session_outcome Tcp_client::processTimerEvent(Timer_name name)
 {
-    sendByeMsgToServer();
-    throw Exception{""};
-}
-
-void Tcp_client::processTimerEvent()
-{
-    if(m_is_waiting_for_reply)
+    if(name.kind == Timer_kind::T_CONNECT_ATTEMPT)
     {
-        sendErrMsgAndTerminate("waited too long for the server's reply.");
+        m_connect_attempt_timer = Timer_wheel::s_INVALID_HANDLE;
+        return startNextConnectionAttempt();
     }
 
-    throw Exception{"timer event, but waiting_for_reply is false."};
-}
-
-void Tcp_client::sendErrMsgAndTerminate(const char* err_msg)
-{
-    buildErrMsg(err_msg);
-    sendMsgToServer();
-    throw Exception{err_msg};
-}
-
-void Tcp_client::processServerMsgMsg(const std::string& msg_msg_from_server)
-{
-    std::smatch matches{};
-    if(std::regex_match(msg_msg_from_server, matches, getMsgMsgRegex()) && isValidDisplayNameLength(matches[1].length())
-        && isValidMsgContentLength(matches[2].length()))
+    if(name.kind == Timer_kind::T_CONNECT_DEADLINE)
     {
-        outputIncomingMsg(matches[1], matches[2]);
-        return;
+        return Session_outcome::fail("couldn't connect to the server: the connection timeout has expired.");
     }
 
-    sendErrMsgAndTerminate("received a malformed MSG message from the server.");
-}
-
-void Tcp_client::processServerErrMsg(const std::string& err_msg_from_server)
-{
-    std::smatch matches{};
-    if(std::regex_match(err_msg_from_server, matches, getErrMsgRegex()) && isValidDisplayNameLength(matches[1].length())
-        && isValidMsgContentLength(matches[2].length()))
+    // The messages the server hasn't accepted in time are dropped
+    if(name.kind == Timer_kind::T_SEND_DEADLINE)
     {
-        printErrFromServer(matches[1], matches[2]);
-        return;
+        return getClosingOutcome();
     }
 
-    sendErrMsgAndTerminate("received a malformed ERR message from the server.");
+    return Session_outcome::fail("timer event of an unknown timer.");
 }
 
-void Tcp_client::processServerByeMsg(const std::string& bye_msg_from_server)
+void Tcp_client::sendMsgToServer(Outbound_msg& msg)
 {
-    std::smatch matches{};
-    if(!std::regex_match(bye_msg_from_server, matches, getByeMsgRegex()) || !isValidDisplayNameLength(matches[1].length()))
+    // The parts are gathered by the kernel, so a long content is sent straight from the user input buffer
+    if(!m_send_queue.send(m_client_socket, msg.getIovecs(), msg.getPartCount()))
     {
-        sendErrMsgAndTerminate("received a malformed BYE message from the server.");
+        setSendQueueError();
+        return;
     }
-}
-
-void Tcp_client::sendByeMsgToServer()
-{
-    buildByeMsg();
-    sendMsgToServer();
-}
 
-void Tcp_client::sendMsgToServer()
-{
-    if(send(m_client_socket, m_msg_to_server.data(), m_msg_to_server.size(), 0) == -1)
-    {
-        throw Exception{"couldn't send a message to the server: send() has failed."};
-    }
+    updateSocketEvents();
 }
 
-// this function was generated by AI
-Protocol_msg_type Tcp_client::getServerMsgType(const std::string& msg_from_server) const
+bool Tcp_client::finishSending()
 {
-    if(msg_from_server.size() >= 3)
+    if(m_send_queue.isEmpty())
     {
-        std::string prefix = msg_from_server.substr(0, strlen("REPLY")); // longest is "REPLY"
-        std::transform(prefix.begin(), prefix.end(), prefix.begin(),
-                       [](unsigned char c) { return std::toupper(c); });
-
-        if (prefix.starts_with("MSG")) return Protocol_msg_type::M_MSG;
-        if (prefix.starts_with("ERR")) return Protocol_msg_type::M_ERR;
-        if (prefix.starts_with("BYE")) return Protocol_msg_type::M_BYE;
-        if (prefix.starts_with("REPLY")) return Protocol_msg_type::M_REPLY;
+        return true;
     }
 
-    return Protocol_msg_type::M_UNKNOWN;
-}
-
-void Tcp_client::buildJoinMsg(const std::string& channel_id)
-{
-    m_msg_to_server = "JOIN " + channel_id + " AS " + m_user_display_name + s_END_OF_MESSAGE;
-}
-
-void Tcp_client::buildMsgMsg(const std::string& user_msg)
-{
-    m_msg_to_server = "MSG FROM " + m_user_display_name + " IS " + user_msg + s_END_OF_MESSAGE;
-}
-
-void Tcp_client::buildAuthMsg(const std::string& username, const std::string& secret)
-{
-    m_msg_to_server = "AUTH " + username + " AS " + m_user_display_name + " USING " + secret + s_END_OF_MESSAGE;
+    // Nothing is received any more, the session only waits until the socket accepts the rest of the queue
+    m_event_loop.modify(m_client_socket, EPOLLOUT);
+    m_is_socket_output_registered = true;
+    startTimer({Timer_kind::T_SEND_DEADLINE}, s_MAX_DRAIN_TIME);
+    return false;
 }
 
-void Tcp_client::buildErrMsg(std::string content)
+void Tcp_client::setSendQueueError()
 {
-    m_msg_to_server = "ERR FROM " + m_user_display_name + " IS " + content + s_END_OF_MESSAGE;
+    setSendError(errno == EPIPE || errno == ECONNRESET ? s_CONNECTION_CLOSED_ERROR : s_SEND_ERROR);
 }
 
-void Tcp_client::buildByeMsg()
+void Tcp_client::updateSocketEvents()
 {
-    m_msg_to_server = "BYE FROM " + m_user_display_name + s_END_OF_MESSAGE;
-}
+    const bool should_be_registered{!m_send_queue.isEmpty()};
 
-const std::regex& Tcp_client::getReplyMsgRegex()
-{
-    static const std::regex value{"REPLY (OK|NOK) IS " + getPrintableCharsSpaceLf() + s_END_OF_MESSAGE, std::regex_constants::icase};
-    return value;
-}
+    if(should_be_registered == m_is_socket_output_registered)
+    {
+        return;
+    }
 
-const std::regex& Tcp_client::getMsgMsgRegex()
-{
-    static const std::regex value{"MSG FROM " + getPrintableChars() + " IS " + getPrintableCharsSpaceLf() + s_END_OF_MESSAGE, std::regex_constants::icase};
-    return value;
-}
+    m_event_loop.modify(m_client_socket, should_be_registered ? EPOLLIN | EPOLLOUT : EPOLLIN);
 
-const std::regex& Tcp_client::getErrMsgRegex()
-{
-    static const std::regex value{"ERR FROM " + getPrintableChars() + " IS " + getPrintableCharsSpaceLf() + s_END_OF_MESSAGE, std::regex_constants::icase};
-    return value;
+    m_is_socket_output_registered = should_be_registered;
 }
 
-const std::regex& Tcp_client::getByeMsgRegex()
+bool Tcp_client::isUserInputEnabled()
 {
-    static const std::regex value{"BYE FROM " + getPrintableChars() + s_END_OF_MESSAGE, std::regex_constants::icase};
-    return value;
+    return isConnected() && m_session.isUserInputEnabled() && m_send_queue.getSize() < s_SEND_QUEUE_HIGH_WATER_MARK;
 }
@@ -0,0 +1,159 @@
+/**
+ * @file tcp-connector.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the non-blocking establishment of the TCP connection.
+ */
+
+#include "tcp-connector.h"
+#include "exception.h"
+#include "socket-address.h"
+#include "event-loop.h"
+#include <algorithm>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h> // close()
+
+Tcp_connector::Tcp_connector(Event_loop& event_loop, Client& owner)
+    :
+    m_event_loop{event_loop},
+    m_owner{owner}
+{
+}
+
+Tcp_connector::~Tcp_connector()
+{
+    closeAttempts();
+}
+
+void Tcp_connector::setServerAddrs(std::vector<struct sockaddr_storage> server_addrs)
+{
+    m_server_addrs = std::move(server_addrs);
+    m_next_addr = 0;
+    interleaveAddressFamilies();
+}
+
+bool Tcp_connector::startNextAttempt()
+{
+    while(hasAddressesLeft())
+    {
+        const struct sockaddr_storage& server_addr{m_server_addrs[m_next_addr++]};
+        const int attempt_socket{socket(server_addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0)};
+
+        // e.g. IPv6 disabled on this host, or no file descriptor left; the address is skipped like a failed connect()
+        if(attempt_socket < 0)
+        {
+            continue;
+        }
+
+        // the result of the connection is reported by EPOLLOUT even if it has been established at once
+        if(connect(attempt_socket, reinterpret_cast<const struct sockaddr*>(&server_addr),
+                   getSocketAddressLength(server_addr)) != 0
+           && errno != EINPROGRESS)
+        {
+            close(attempt_socket);
+            continue;
+        }
+
+        try
+        {
+            m_event_loop.add(attempt_socket, EPOLLOUT, m_owner);
+        }
+        catch(const Exception&)
+        {
+            close(attempt_socket);
+            throw;
+        }
+
+        m_attempt_sockets.push_back(attempt_socket);
+        return true;
+    }
+
+    return false;
+}
+
+int Tcp_connector::processEvent(int socket, uint32_t events)
+{
+    if(std::find(m_attempt_sockets.begin(), m_attempt_sockets.end(), socket) == m_attempt_sockets.end())
+    {
+        throw Exception{"event on an unknown file descriptor."};
+    }
+
+    int socket_error{0};
+    socklen_t socket_error_size{sizeof(socket_error)};
+
+    if(getsockopt(socket, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_size) != 0)
+    {
+        socket_error = errno;
+    }
+
+    removeAttempt(socket);
+
+    if(socket_error != 0 || (events & (EPOLLERR | EPOLLHUP)))
+    {
+        close(socket);
+        return -1;
+    }
+
+    closeAttempts();
+    return socket;
+}
+
+void Tcp_connector::closeAttempts()
+{
+    while(!m_attempt_sockets.empty())
+    {
+        const int attempt_socket{m_attempt_sockets.back()};
+        removeAttempt(attempt_socket);
+        close(attempt_socket);
+    }
+}
+
+bool Tcp_connector::hasPendingAttempts() const
+{
+    return !m_attempt_sockets.empty();
+}
+
+bool Tcp_connector::hasAddressesLeft() const
+{
+    return m_next_addr < m_server_addrs.size();
+}
+
+void Tcp_connector::interleaveAddressFamilies()
+{
+    if(m_server_addrs.empty())
+    {
+        return;
+    }
+
+    const sa_family_t first_family{m_server_addrs.front().ss_family};
+    std::vector<struct sockaddr_storage> first_family_addrs{};
+    std::vector<struct sockaddr_storage> other_family_addrs{};
+
+    for(const struct sockaddr_storage& server_addr : m_server_addrs)
+    {
+        (server_addr.ss_family == first_family ? first_family_addrs : other_family_addrs).push_back(server_addr);
+    }
+
+    m_server_addrs.clear();
+
+    for(std::size_t i{0}; i < std::max(first_family_addrs.size(), other_family_addrs.size()); ++i)
+    {
+        if(i < first_family_addrs.size())
+        {
+            m_server_addrs.push_back(first_family_addrs[i]);
+        }
+
+        if(i < other_family_addrs.size())
+        {
+            m_server_addrs.push_back(other_family_addrs[i]);
+        }
+    }
+}
+
+void Tcp_connector::removeAttempt(int socket)
+{
+    // the winner is registered again by the client
+    m_event_loop.remove(socket);
+    m_attempt_sockets.erase(std::find(m_attempt_sockets.begin(), m_attempt_sockets.end(), socket));
+}
@@ -0,0 +1,107 @@
+/**
+ * @file tcp-msg-parser.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the parser of messages received by the TCP version of IPK25-CHAT client.
+ */
+
+#include "tcp-msg-parser.h"
+#include "tcp-session.h"
+#include "char-class.h"
+
+Protocol_msg_type Tcp_msg_parser::getMsgType(std::string_view msg)
+{
+    if(msg.size() >= 3)
+    {
+        std::string_view prefix{msg};
+
+        if(consumeKeyword(prefix, "MSG")) return Protocol_msg_type::M_MSG;
+        if(consumeKeyword(prefix, "ERR")) return Protocol_msg_type::M_ERR;
+        if(consumeKeyword(prefix, "BYE")) return Protocol_msg_type::M_BYE;
+        if(consumeKeyword(prefix, "REPLY")) return Protocol_msg_type::M_REPLY;
+    }
+
+    return Protocol_msg_type::M_UNKNOWN;
+}
+
+Tcp_server_msg Tcp_msg_parser::parse(std::string_view msg)
+{
+    Tcp_server_msg result{};
+    result.type = getMsgType(msg);
+
+    switch(result.type)
+    {
+        case Protocol_msg_type::M_MSG:
+        case Protocol_msg_type::M_ERR:
+            result.is_valid = consumeKeyword(msg, result.type == Protocol_msg_type::M_MSG ? "MSG FROM " : "ERR FROM ")
+                && consumeField(msg, Char_class::s_PRINTABLE, result.display_name)
+                && consumeKeyword(msg, " IS ")
+                && consumeField(msg, Char_class::s_PRINTABLE_SPACE_LF, result.content)
+                && isEndOfMsg(msg);
+            break;
+
+        case Protocol_msg_type::M_BYE:
+            result.is_valid = consumeKeyword(msg, "BYE FROM ")
+                && consumeField(msg, Char_class::s_PRINTABLE, result.display_name)
+                && isEndOfMsg(msg);
+            break;
+
+        case Protocol_msg_type::M_REPLY:
+            if(!consumeKeyword(msg, "REPLY "))
+            {
+                break;
+            }
+
+            result.is_positive_reply = consumeKeyword(msg, "OK");
+            result.is_valid = (result.is_positive_reply || consumeKeyword(msg, "NOK"))
+                && consumeKeyword(msg, " IS ")
+                && consumeField(msg, Char_class::s_PRINTABLE_SPACE_LF, result.content)
+                && isEndOfMsg(msg);
+            break;
+
+        default:
+            break;
+    }
+
+    return result;
+}
+
+bool Tcp_msg_parser::consumeKeyword(std::string_view& msg, std::string_view keyword)
+{
+    if(msg.size() < keyword.size())
+    {
+        return false;
+    }
+
+    for(std::size_t i{0}; i < keyword.size(); ++i)
+    {
+        // keywords consist of upper-case letters and spaces only, so clearing bit 0x20 of a letter is enough
+        const char c{Char_class::is(keyword[i], Char_class::s_PRINTABLE) ? static_cast<char> (msg[i] & ~0x20) : msg[i]};
+
+        if(c != keyword[i])
+        {
+            return false;
+        }
+    }
+
+    msg.remove_prefix(keyword.size());
+    return true;
+}
+
+bool Tcp_msg_parser::consumeField(std::string_view& msg, uint8_t char_class, std::string_view& field)
+{
+    const std::size_t field_length{Char_class::span(msg, char_class)};
+
+    if(field_length == 0)
+    {
+        return false;
+    }
+
+    field = msg.substr(0, field_length);
+    msg.remove_prefix(field_length);
+    return true;
+}
+
+bool Tcp_msg_parser::isEndOfMsg(std::string_view msg)
+{
+    return msg == Tcp_session::s_END_OF_MESSAGE;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file tcp-session.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the protocol core of the TCP version of IPK25-CHAT client.
+ */
+
+#include "tcp-session.h"
+#include <algorithm>
+
+Tcp_session::Tcp_session(Clock::time_point now)
+    :
+    Protocol_session{now},
+    m_msg_from_server{s_RECEIVE_BUFFER_SIZE, s_END_OF_MESSAGE}
+{
+}
+
+char* Tcp_session::getReceiveSpace()
+{
+    // Views of the messages processed by the previous call are no longer needed
+    m_msg_from_server.compact();
+    return m_msg_from_server.getFreeSpace();
+}
+
+std::size_t Tcp_session::getReceiveSpaceSize() const
+{
+    return m_msg_from_server.getFreeSpaceSize();
+}
+
+const Action_list& Tcp_session::processReceived(std::string_view data, Clock::time_point now)
+{
+    char* const receive_space{getReceiveSpace()};
+    const std::size_t length{std::min(data.size(), getReceiveSpaceSize())};
+
+    std::copy_n(data.data(), length, receive_space);
+
+    if(length < data.size())
+    {
+        // The buffer holds an incomplete message plus a full message, so the data can't fit only if it is too long
+        m_msg_from_server.commit(length);
+        return processTransportError("too long message from server.", now);
+    }
+
+    return processReceived(length, now);
+}
+
+const Action_list& Tcp_session::processReceived(std::size_t length, Clock::time_point now)
+{
+    if(!beginCall(now))
+    {
+        return endCall();
+    }
+
+    m_msg_from_server.commit(length);
+    std::string_view single_msg{};
+
+    // Keep processing as long as we have complete messages
+    while(!isClosed() && m_msg_from_server.nextFrame(single_msg))
+    {
+        // Validate length
+        if(single_msg.size() > s_MAX_MSG_SIZE)
+        {
+            sendErrMsgAndTerminate("too long message from server.");
+            return endCall();
+        }
+
+        // Process the single complete message
+        processMessageFromServer(single_msg);
+    }
+
+    // Validate length
+    if(!isClosed() && m_msg_from_server.getPendingSize() >= s_MAX_MSG_SIZE)
+    {
+        sendErrMsgAndTerminate("too long message from server.");
+    }
+
+    return endCall();
+}
+
+const Action_list& Tcp_session::processStreamEnd(Clock::time_point now)
+{
+    // Connection closed by the server
+    if(beginCall(now))
+    {
+        addCloseAction(true, "");
+    }
+
+    return endCall();
+}
+
+bool Tcp_session::isUserInputEnabled() const
+{
+    return !isClosed() && !m_is_waiting_for_reply;
+}
+
+void Tcp_session::processUserInput(const User_input& user_input)
+{
+    if(user_input.type == User_input_type::U_AUTH)
+    {
+        m_user_display_name = user_input.display_name;
+    }
+
+    if(user_input.type == User_input_type::U_JOIN)
+    {
+        m_current_state = FSM_state::S_JOIN;
+    }
+
+    if(!buildUserMsgToServer(user_input))
+    {
+        return;
+    }
+
+    addSendAction();
+
+    if(user_input.type == User_input_type::U_AUTH && m_current_state == FSM_state::S_START)
+    {
+        m_current_state = FSM_state::S_AUTH;
+    }
+
+    if(user_input.type == User_input_type::U_AUTH || user_input.type == User_input_type::U_JOIN)
+    {
+        m_reply_timer = startTimer({Timer_kind::T_REPLY}, std::chrono::seconds{s_MAX_REPLY_WAIT_TIME});
+        m_is_waiting_for_reply = true;
+    }
+}
+
+void Tcp_session::processEof()
+{
+    sendByeMsgAndTerminate();
+}
+
+void Tcp_session::processInterrupt()
+{
+    sendByeMsgAndTerminate();
+}
+
+void Tcp_session::processTransportFailure(const char* reason)
+{
+    sendErrMsgAndTerminate(reason);
+}
+
+void Tcp_session::processServerReplyMsg(const Tcp_server_msg& reply_msg_from_server)
+{
+    if(m_current_state != FSM_state::S_AUTH && m_current_state != FSM_state::S_JOIN)
+    {
+        sendErrMsgAndTerminate("received a REPLY message in unexpected state.");
+        return;
+    }
+
+    if(!m_is_waiting_for_reply)
+    {
+        sendErrMsgAndTerminate("didn't expect any reply message from the server.");
+        return;
+    }
+
+    if(!reply_msg_from_server.is_valid || !isValidMsgContentLength(reply_msg_from_server.content.length()))
+    {
+        sendErrMsgAndTerminate("received a malformed REPLY message from the server.");
+        return;
+    }
+
+    stopTimer(m_reply_timer);
+    outputIncomingReply(reply_msg_from_server.is_positive_reply, reply_msg_from_server.content);
+    if(m_current_state == FSM_state::S_JOIN || reply_msg_from_server.is_positive_reply)
+    {
+        m_current_state = FSM_state::S_OPEN;
+    }
+    m_is_waiting_for_reply = false;
+}
+
+void Tcp_session::processMessageFromServer(std::string_view msg_from_server)
+{
+    const Tcp_server_msg parsed_msg_from_server{Tcp_msg_parser::parse(msg_from_server)};
+    const Protocol_msg_type type_of_msg_from_server{parsed_msg_from_server.type};
+
+    if(type_of_msg_from_server == Protocol_msg_type::M_UNKNOWN)
+    {
+        sendErrMsgAndTerminate("only messages of types BYE, ERR, MSG and REPLY are expected to be received"
+                        " from the server.");
+        return;
+    }
+
+    if(type_of_msg_from_server == Protocol_msg_type::M_BYE)
+    {
+        processServerByeMsg(parsed_msg_from_server);
+        return;
+    }
+
+    if(type_of_msg_from_server == Protocol_msg_type::M_ERR)
+    {
+        processServerErrMsg(parsed_msg_from_server);
+        return;
+    }
+
+    switch(m_current_state)
+    {
+        case FSM_state::S_START:
+            sendErrMsgAndTerminate("only messages of types BYE and ERR are expected to be received"
+                        " from the server in the client's START state.");
+            break;
+
+        case FSM_state::S_AUTH:
+            if(type_of_msg_from_server == Protocol_msg_type::M_REPLY)
+            {
+                processServerReplyMsg(parsed_msg_from_server);
+                break;
+            }
+
+            sendErrMsgAndTerminate("only messages of types BYE, ERR and REPLY are expected to be received"
+                " from the server in the client's AUTH state.");
+            break;
+
+        case FSM_state::S_OPEN:
+            if(type_of_msg_from_server == Protocol_msg_type::M_MSG)
+            {
+                processServerMsgMsg(parsed_msg_from_server);
+            }
+            else
+            {
+                sendErrMsgAndTerminate("only messages of types BYE, ERR and MSG are expected to be received"
+                    " from the server in the client's OPEN state.");
+            }
+            break;
+
+        case FSM_state::S_JOIN:
+            switch(type_of_msg_from_server)
+            {
+                case Protocol_msg_type::M_REPLY:
+                    processServerReplyMsg(parsed_msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_MSG:
+                    processServerMsgMsg(parsed_msg_from_server);
+                    break;
+
+                default:
+                    sendErrMsgAndTerminate("only messages of types BYE, ERR, MSG and REPLY are expected to be received"
+                        " from the server in the client's JOIN state.");
+            }
+            break;
+
+        default:
+            addCloseAction(false, "Invalid client's FSM state.");
+    }
+}
+
+void Tcp_session::processTimerEvent(Timer_name name)
+{
+    if(name.kind == Timer_kind::T_REPLY && m_is_waiting_for_reply)
+    {
+        sendErrMsgAndTerminate("waited too long for the server's reply.");
+        return;
+    }
+
+    addCloseAction(false, "timer event, but waiting_for_reply is false.");
+}
+
+void Tcp_session::sendByeMsgAndTerminate()
+{
+    buildByeMsg();
+    addSendAction();
+    addCloseAction(true, "");
+}
+
+void Tcp_session::sendErrMsgAndTerminate(const char* err_msg)
+{
+    buildErrMsg(err_msg);
+    addSendAction();
+    addCloseAction(false, err_msg);
+}
+
+void Tcp_session::processServerMsgMsg(const Tcp_server_msg& msg_msg_from_server)
+{
+    if(msg_msg_from_server.is_valid && isValidDisplayNameLength(msg_msg_from_server.display_name.length())
+        && isValidMsgContentLength(msg_msg_from_server.content.length()))
+    {
+        outputIncomingMsg(msg_msg_from_server.display_name, msg_msg_from_server.content);
+        return;
+    }
+
+    sendErrMsgAndTerminate("received a malformed MSG message from the server.");
+}
+
+void Tcp_session::processServerErrMsg(const Tcp_server_msg& err_msg_from_server)
+{
+    if(err_msg_from_server.is_valid && isValidDisplayNameLength(err_msg_from_server.display_name.length())
+        && isValidMsgContentLength(err_msg_from_server.content.length()))
+    {
+        printErrFromServer(err_msg_from_server.display_name, err_msg_from_server.content);
+        addCloseAction(false, "");
+        return;
+    }
+
+    sendErrMsgAndTerminate("received a malformed ERR message from the server.");
+}
+
+void Tcp_session::processServerByeMsg(const Tcp_server_msg& bye_msg_from_server)
+{
+    if(!bye_msg_from_server.is_valid || !isValidDisplayNameLength(bye_msg_from_server.display_name.length()))
+    {
+        sendErrMsgAndTerminate("received a malformed BYE message from the server.");
+        return;
+    }
+
+    addCloseAction(true, "");
+}
+
+void Tcp_session::buildJoinMsg(std::string_view channel_id)
+{
+    m_msg_to_server.assign({"JOIN ", channel_id, " AS ", m_user_display_name, s_END_OF_MESSAGE});
+}
+
+void Tcp_session::buildMsgMsg(std::string_view user_msg)
+{
+    m_msg_to_server.assign({"MSG FROM ", m_user_display_name, " IS ", user_msg, s_END_OF_MESSAGE});
+}
+
+void Tcp_session::buildAuthMsg(std::string_view username, std::string_view secret)
+{
+    m_msg_to_server.assign({"AUTH ", username, " AS ", m_user_display_name, " USING ", secret, s_END_OF_MESSAGE});
+}
+
+void Tcp_session::buildErrMsg(std::string_view content)
+{
+    m_msg_to_server.assign({"ERR FROM ", m_user_display_name, " IS ", content, s_END_OF_MESSAGE});
+}
+
+void Tcp_session::buildByeMsg()
+{
+    m_msg_to_server.assign({"BYE FROM ", m_user_display_name, s_END_OF_MESSAGE});
+}
@@ -0,0 +1,68 @@
+/**
+ * @file tcp-stream-buffer.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the buffer reassembling messages from the TCP byte stream.
+ */
+
+#include "tcp-stream-buffer.h"
+#include <cstring> // std::memmove()
+
+Tcp_stream_buffer::Tcp_stream_buffer(std::size_t capacity, std::string_view frame_terminator)
+    :
+    m_data{std::make_unique_for_overwrite<char[]>(capacity)},
+    m_capacity{capacity},
+    m_frame_terminator{frame_terminator}
+{
+
+}
+
+char* Tcp_stream_buffer::getFreeSpace()
+{
+    return m_data.get() + m_end;
+}
+
+std::size_t Tcp_stream_buffer::getFreeSpaceSize() const
+{
+    return m_capacity - m_end;
+}
+
+void Tcp_stream_buffer::commit(std::size_t received_bytes)
+{
+    m_end += received_bytes;
+}
+
+bool Tcp_stream_buffer::nextFrame(std::string_view& frame)
+{
+    const std::string_view pending{m_data.get() + m_begin, m_end - m_begin};
+    const std::size_t terminator_position{pending.find(m_frame_terminator, m_scan - m_begin)};
+
+    if(terminator_position == std::string_view::npos)
+    {
+        // the last bytes may be the beginning of a terminator split between two reads
+        m_scan = pending.size() < m_frame_terminator.size() ? m_begin : m_end - m_frame_terminator.size() + 1;
+        return false;
+    }
+
+    frame = pending.substr(0, terminator_position + m_frame_terminator.size());
+    m_begin += frame.size();
+    m_scan = m_begin;
+    return true;
+}
+
+std::size_t Tcp_stream_buffer::getPendingSize() const
+{
+    return m_end - m_begin;
+}
+
+void Tcp_stream_buffer::compact()
+{
+    if(m_begin == 0)
+    {
+        return;
+    }
+
+    std::memmove(m_data.get(), m_data.get() + m_begin, m_end - m_begin);
+    m_end -= m_begin;
+    m_scan -= m_begin;
+    m_begin = 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file timer-wheel.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the hashed timer wheel.
+ */
+
+#include "timer-wheel.h"
+#include <algorithm>
+
+Timer_wheel::Timer_wheel(Clock::time_point now)
+    :
+    m_current_tick{toTick(now)}
+{
+    m_slots.fill(s_NO_NODE);
+}
+
+int64_t Timer_wheel::toTick(Clock::time_point time_point)
+{
+    return std::chrono::ceil<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
+}
+
+Timer_wheel::Timer_handle Timer_wheel::schedule(Clock::time_point deadline, Timer_name name)
+{
+    Node_index index{m_free_nodes};
+
+    if(index == s_NO_NODE)
+    {
+        index = static_cast<Node_index>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        m_free_nodes = m_nodes[index].next;
+    }
+
+    // expired timers are reported by the next call of expire()
+    const int64_t expiry_tick{std::max(toTick(deadline), m_current_tick)};
+    Node_index& slot{m_slots[static_cast<uint64_t>(expiry_tick) % s_SLOT_COUNT]};
+
+    Node& node{m_nodes[index]};
+    node = Node{expiry_tick, name, s_NO_NODE, slot, node.generation};
+
+    if(slot != s_NO_NODE)
+    {
+        m_nodes[slot].prev = index;
+    }
+
+    slot = index;
+    ++m_scheduled_count;
+
+    if(m_is_earliest_tick_valid && (!m_earliest_tick || expiry_tick < *m_earliest_tick))
+    {
+        m_earliest_tick = expiry_tick;
+    }
+
+    return static_cast<Timer_handle>(node.generation) << 32 | index;
+}
+
+void Timer_wheel::cancel(Timer_handle& handle)
+{
+    if(handle == s_INVALID_HANDLE)
+    {
+        return;
+    }
+
+    const Node_index index{static_cast<Node_index>(handle)};
+
+    // the node has been released since the handle was returned (the timer has expired or been cancelled)
+    if(m_nodes[index].generation == static_cast<uint32_t>(handle >> 32))
+    {
+        release(index);
+    }
+
+    handle = s_INVALID_HANDLE;
+}
+
+void Timer_wheel::release(Node_index index)
+{
+    Node& node{m_nodes[index]};
+
+    if(node.prev == s_NO_NODE)
+    {
+        m_slots[static_cast<uint64_t>(node.expiry_tick) % s_SLOT_COUNT] = node.next;
+    }
+    else
+    {
+        m_nodes[node.prev].next = node.next;
+    }
+
+    if(node.next != s_NO_NODE)
+    {
+        m_nodes[node.next].prev = node.prev;
+    }
+
+    if(m_earliest_tick && node.expiry_tick == *m_earliest_tick)
+    {
+        m_is_earliest_tick_valid = false;
+    }
+
+    ++node.generation;
+    node.prev = s_NO_NODE;
+    node.next = m_free_nodes;
+    m_free_nodes = index;
+    --m_scheduled_count;
+}
+
+void Timer_wheel::expire(Clock::time_point now, std::vector<Timer_name>& expired_names)
+{
+    // a timer is due once its whole millisecond has passed
+    const int64_t now_tick{std::chrono::floor<std::chrono::milliseconds>(now.time_since_epoch()).count()};
+
+    if(now_tick < m_current_tick)
+    {
+        return;
+    }
+
+    // each slot has to be visited at most once, even if the wheel wasn't turned for more than one rotation
+    const int64_t last_tick{std::min(now_tick, m_current_tick + s_SLOT_COUNT - 1)};
+
+    for(int64_t tick{m_current_tick}; tick <= last_tick && m_scheduled_count > 0; ++tick)
+    {
+        Node_index index{m_slots[static_cast<uint64_t>(tick) % s_SLOT_COUNT]};
+
+        while(index != s_NO_NODE)
+        {
+            const Node_index next{m_nodes[index].next};
+
+            if(m_nodes[index].expiry_tick <= now_tick)
+            {
+                expired_names.push_back(m_nodes[index].name);
+                release(index);
+            }
+
+            index = next;
+        }
+    }
+
+    m_current_tick = now_tick + 1;
+}
+
+std::optional<Timer_wheel::Clock::time_point> Timer_wheel::getEarliestDeadline()
+{
+    if(!m_is_earliest_tick_valid)
+    {
+        m_earliest_tick = findEarliestTick();
+        m_is_earliest_tick_valid = true;
+    }
+
+    if(!m_earliest_tick)
+    {
+        return std::nullopt;
+    }
+
+    return Clock::time_point{std::chrono::duration_cast<Clock::duration>(std::chrono::milliseconds{*m_earliest_tick})};
+}
+
+std::optional<int64_t> Timer_wheel::findEarliestTick() const
+{
+    std::optional<int64_t> earliest_tick{};
+
+    // every scheduled timer expires at the current tick or later, so the first slot holding a timer of its own tick
+    // contains the earliest one; a full rotation without such a slot has visited every timer
+    for(int64_t tick{m_current_tick}; tick < m_current_tick + s_SLOT_COUNT && m_scheduled_count > 0; ++tick)
+    {
+        for(Node_index index{m_slots[static_cast<uint64_t>(tick) % s_SLOT_COUNT]}; index != s_NO_NODE;
+            index = m_nodes[index].next)
+        {
+            const int64_t expiry_tick{m_nodes[index].expiry_tick};
+
+            if(expiry_tick == tick)
+            {
+                return expiry_tick;
+            }
+
+            if(!earliest_tick || expiry_tick < *earliest_tick)
+            {
+                earliest_tick = expiry_tick;
+            }
+        }
+    }
+
+    return earliest_tick;
+}
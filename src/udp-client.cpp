@@ -7,669 +7,264 @@
 #include "udp-client.h"
 #include "exception.h"
 #include "error.h"
-#include <iostream>
-#include <regex>
-#include <csignal>
-#include <iomanip>
+#include <cstring>
+#include "socket-address.h"
 
-Udp_client::Udp_client(const Args& args)
+Udp_client::Udp_client(const Args& args, Event_loop& event_loop, std::shared_ptr<Input_source> input_source,
+                       Chat_callbacks callbacks)
     :
-    Client::Client{args},
-    m_msg_to_server_id{0}
+    Client::Client{args, event_loop, std::move(input_source), std::move(callbacks)},
+    m_receive_buffers{std::make_unique_for_overwrite<char[]>(s_RECEIVE_BATCH_SIZE * s_RECEIVE_BUFFER_SIZE)},
+    m_session{getSessionConfig(), Timer_wheel::Clock::now()}
 {
-
-}
-
-uint8_t Udp_client::processMessageFromServer(const std::string& msg_from_server, unsigned msg_from_server_length, sockaddr_in& server_addr)
-{
-    if(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])) == Protocol_msg_type::M_BYE)
-    {
-        return processServerByeMsg(msg_from_server, msg_from_server_length);
-    }
-
-    if(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])) == Protocol_msg_type::M_ERR)
+    for(unsigned i{0}; i < s_RECEIVE_BATCH_SIZE; ++i)
     {
-        return processServerErrMsg(msg_from_server, msg_from_server_length);
+        m_receive_iovecs[i] = {getReceiveBuffer(i), s_RECEIVE_BUFFER_SIZE};
+        m_receive_headers[i].msg_hdr.msg_iov = &m_receive_iovecs[i];
+        m_receive_headers[i].msg_hdr.msg_iovlen = 1;
+        m_receive_headers[i].msg_hdr.msg_name = &m_receive_addrs[i];
     }
 
-    switch(m_current_state)
+    for(unsigned i{0}; i < s_CONFIRM_BATCH_SIZE; ++i)
     {
-        case FSM_state::S_START:
-            switch(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])))
-            {
-                case Protocol_msg_type::M_CONFIRM:
-                    return processServerConfirmMsg(msg_from_server, msg_from_server_length);
-
-                default:
-                    sendErrMsg("ERROR: only messages of types BYE, ERR or CONFIRM are expected to be received"
-                        " from the server in the client's START state.");
-                    break;
-            }
-            break;
-        case FSM_state::S_AUTH:
-            switch(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])))
-            {
-                case Protocol_msg_type::M_CONFIRM:
-                    return processServerConfirmMsg(msg_from_server, msg_from_server_length);
-
-                case Protocol_msg_type::M_REPLY:
-                    processServerReplyMsg(msg_from_server, msg_from_server_length, server_addr);
-                    break;
-
-                case Protocol_msg_type::M_PING:
-                    processServerPingMsg(msg_from_server, msg_from_server_length);
-                    break;
-
-                default:
-                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING and REPLY are expected to be received"
-                        " from the server in the client's AUTH state.");
-                    break;
-            }
-            break;
-        case FSM_state::S_OPEN:
-            switch(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])))
-            {
-                case Protocol_msg_type::M_CONFIRM:
-                    return processServerConfirmMsg(msg_from_server, msg_from_server_length);
-
-                case Protocol_msg_type::M_MSG:
-                    processServerMsgMsg(msg_from_server, msg_from_server_length);
-                    break;
-
-                case Protocol_msg_type::M_PING:
-                    processServerPingMsg(msg_from_server, msg_from_server_length);
-                    break;
-
-                default:
-                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING, JOIN and MSG are expected to be received"
-                        " from the server in the client's OPEN state.");
-                    break;
-            }
-            break;
-
-        case FSM_state::S_JOIN:
-            switch(static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_from_server[0])))
-            {
-                case Protocol_msg_type::M_MSG:
-                    processServerMsgMsg(msg_from_server, msg_from_server_length);
-                    break;
-
-                case Protocol_msg_type::M_PING:
-                    processServerPingMsg(msg_from_server, msg_from_server_length);
-                    break;
-
-                case Protocol_msg_type::M_REPLY:
-                    processServerReplyMsg(msg_from_server, msg_from_server_length, server_addr);
-                    break;
-
-                case Protocol_msg_type::M_CONFIRM:
-                    return processServerConfirmMsg(msg_from_server, msg_from_server_length);
-
-                default:
-                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING, REPLY and MSG are expected to be received"
-                        " from the server in the client's JOIN state.");
-                    break;
-            }
-            break;
-
-        default:
-            sendErrMsg("invalid client's FSM state.");
-            break;
+        m_confirm_iovecs[i] = {m_confirm_msgs[i].data(), m_confirm_msgs[i].size()};
+        m_confirm_headers[i].msg_hdr.msg_iov = &m_confirm_iovecs[i];
+        m_confirm_headers[i].msg_hdr.msg_iovlen = 1;
+        m_confirm_headers[i].msg_hdr.msg_name = &m_confirm_addrs[i];
     }
-
-    return 2;
 }
 
-uint8_t Udp_client::processSocketEvent()
+Protocol_session& Udp_client::getSession()
 {
-    sockaddr_in server_addr{};
-    socklen_t server_addr_len{sizeof(server_addr)};
-
-    const long server_msg_length{recvfrom(m_client_socket, m_server_msg.get(), s_MAX_MSG_SIZE + 1, 0,
-        reinterpret_cast<sockaddr*>(&server_addr), &server_addr_len)};
-
-    if(server_msg_length < 0)
-    {
-        sendErrMsg("ERROR: couldn't receive a message from the server: recv() has failed.");
-        return 2;
-    }
-
-    if(server_msg_length > s_MAX_MSG_SIZE)
-    {
-
-        sendErrMsg("ERROR: too long message from server.");
-        return 2;
-    }
-
-    std::string msg_from_server{m_server_msg.get(), static_cast<unsigned long> (server_msg_length)};
-    return processMessageFromServer(msg_from_server, server_msg_length, server_addr);
+    return m_session;
 }
 
-bool Udp_client::isValidConfirmMsg(const std::string& confirm_msg, unsigned confirm_msg_length) const
+Session_outcome Udp_client::processServerAddrsResolved()
 {
-    return static_cast<Protocol_msg_type> (static_cast<unsigned char> (confirm_msg[0])) == Protocol_msg_type::M_CONFIRM &&
-        isValidConfirmMsgLength(confirm_msg_length);
+    return createClientSocket();
 }
 
-uint8_t Udp_client::processServerConfirmMsg(const std::string& confirm_msg, unsigned confirm_msg_length)
+Session_outcome Udp_client::processSocketEvent(uint32_t events)
 {
-    switch(m_current_state)
+    if((events & EPOLLERR) && !clearSocketError())
     {
-        case FSM_state::S_START:
-        case FSM_state::S_AUTH:
-        case FSM_state::S_OPEN:
-        case FSM_state::S_JOIN:
-            break;
-        default:
-            sendErrMsg("ERROR: received a CONFIRM message in unexpected state.");
-            return 2;
+        return executeActions(m_session.processTransportError("an error occurred on the client socket.",
+            Timer_wheel::Clock::now()));
     }
 
-    if(isValidConfirmMsg(confirm_msg, confirm_msg_length))
+    ++m_receive_stats.wakeup_count;
+    unsigned datagrams_in_wakeup{0};
+
+    // Drain the socket: keep receiving batches until there are no more datagrams waiting
+    while(true)
     {
-        if(getMsgId(confirm_msg) == m_msg_to_server_id)
+        // Source addresses are needed only until the socket is connected
+        for(auto& header : m_receive_headers)
         {
-            if(static_cast<unsigned char> (m_msg_to_server[0]) == static_cast<unsigned char> (Protocol_msg_type::M_BYE))
-            {
-                return 0;
-            }
+            header.msg_hdr.msg_namelen = m_is_socket_connected ? 0 : sizeof(sockaddr_storage);
+        }
+
+        const int datagram_count{recvmmsg(m_client_socket, m_receive_headers.data(), s_RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr)};
 
-            if(static_cast<unsigned char> (m_msg_to_server[0]) == static_cast<unsigned char> (Protocol_msg_type::M_ERR))
+        if(datagram_count < 0)
+        {
+            // The rest of the datagrams is received by the next event
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED)
             {
-                return 1;
+                break;
             }
 
-            switch(m_current_state)
+            const Session_outcome outcome{executeActions(m_session.processTransportError(
+                "couldn't receive a message from the server: recv() has failed.", Timer_wheel::Clock::now()))};
+
+            if(outcome.isFinished())
             {
-                case FSM_state::S_START:
-                    // sendErrMsg("ERROR: confirm to unexpected message in the START state.");
-                    break;
-
-                case FSM_state::S_AUTH:
-                    switch(static_cast<unsigned char> (m_msg_to_server[0]))
-                    {
-                        case static_cast<unsigned char> (Protocol_msg_type::M_AUTH):
-                            m_is_waiting_for_confirm = false;
-                            m_is_waiting_for_reply = true;
-                            m_allowed_retransmissions = m_args.getUdpMaxRetransCount();
-                            ++m_msg_to_server_id;
-                            startTimer(s_MAX_REPLY_WAIT_TIME * 1000); // Time in ms
-                            break;
-                        default:
-                            // sendErrMsg("ERROR: confirm to unexpected message in AUTH state.");
-                            break;
-                    }
-                    break;
-
-
-                case FSM_state::S_OPEN:
-                    switch(static_cast<unsigned char> (m_msg_to_server[0]))
-                    {
-                        case static_cast<unsigned char> (Protocol_msg_type::M_MSG):
-                            stopTimer();
-                            m_is_waiting_for_confirm = false;
-                            m_allowed_retransmissions = m_args.getUdpMaxRetransCount();
-                            ++m_msg_to_server_id;
-                            enableStdinEvents();
-                            break;
-
-                        case static_cast<unsigned char> (Protocol_msg_type::M_JOIN):
-                            m_is_waiting_for_confirm = false;
-                            m_is_waiting_for_reply = true;
-                            m_allowed_retransmissions = m_args.getUdpMaxRetransCount();
-                            ++m_msg_to_server_id;
-                            m_current_state = FSM_state::S_JOIN;
-                            startTimer(s_MAX_REPLY_WAIT_TIME * 1000); // Time in ms
-                            break;
-
-                        default:
-                            // sendErrMsg("ERROR: confirm to unexpected message in OPEN state.");
-                            break;
-                    }
-                    break;
-
-                case FSM_state::S_JOIN:
-                    // sendErrMsg("ERROR: confirm to unexpected message in the START state.");
-                    break;
-
-                default:
-                    sendErrMsg("ERROR: received a CONFIRM message in unexpected state.");
-                    break;
+                updateReceiveStats(datagrams_in_wakeup);
+                return outcome;
             }
+            break;
         }
 
-        return 2;
-    }
+        datagrams_in_wakeup += datagram_count;
 
-    sendErrMsg("ERROR: received a malformed CONFIRM message from the server.");
-    return 2;
-}
-
-void Udp_client::sendErrMsg(const char* err_msg)
-{
-    buildErrMsg(err_msg);
-    printErrMsg(m_msg_to_server.substr(s_BYTES_IN_MSG_HEADER + m_user_display_name.size()
-        + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) + strlen("ERROR: ")));
-    sendMsgToServer();
-    disableStdinEvents();
-    startTimer(m_args.getUdpConfirmTimeout()); // Time in ms
-    m_is_waiting_for_confirm = true;
-    m_is_waiting_for_reply = false;
-}
-
-bool Udp_client::isValidConfirmMsgLength(unsigned confirm_msg_length) const
-{
-    return confirm_msg_length == s_BYTES_IN_MSG_HEADER;
-}
-
-void Udp_client::sigintHandler()
-{
-    sendByeMsgToServer();
-}
+        for(int i{0}; i < datagram_count; ++i)
+        {
+            m_datagram_addr = &m_receive_addrs[i];
+            const Session_outcome outcome{executeActions(m_session.processDatagram(
+                {getReceiveBuffer(i), m_receive_headers[i].msg_len}, Timer_wheel::Clock::now()))};
 
-void Udp_client::processTimerEvent()
-{
-    uint64_t expirations{};
-    ssize_t bytes_read = read(m_timer_fd, &expirations, sizeof(expirations));
-    (void) bytes_read;
+            if(outcome.isFinished())
+            {
+                flushConfirmMsgs();
+                updateReceiveStats(datagrams_in_wakeup);
+                return outcome;
+            }
+        }
 
-    if(m_is_waiting_for_confirm || m_is_waiting_for_bye_confirm)
-    {
-        if(m_allowed_retransmissions == 0)
+        // Acknowledge the whole batch at once
+        if(!flushConfirmMsgs())
         {
-            throw Exception{"exceeded udp max retransmission number."};
+            updateReceiveStats(datagrams_in_wakeup);
+            return processSendError();
         }
 
-        sendMsgToServer();
-        startTimer(m_args.getUdpConfirmTimeout()); // Time in ms
-        --m_allowed_retransmissions;
-    }
-    else if(m_is_waiting_for_reply)
-    {
-        sendErrMsg("ERROR: waited too long for the server's reply.");
-    }
-    else
-    {
-        throw Exception{"timer event, but m_is_waiting_for_confirm and m_is_waiting_for_reply are false."};
-    }
-}
-
-bool Udp_client::isValidMsgMsg(const std::string& msg_msg, unsigned msg_msg_length) const
-{
-    if(!isValidMsgMsgLength(msg_msg_length) || static_cast<Protocol_msg_type> (static_cast<unsigned char> (msg_msg[0])) != Protocol_msg_type::M_MSG)
-    {
-        return false;
-    }
-
-    std::smatch matches{};
-
-    std::string skipped_msg_header{msg_msg.substr(s_BYTES_IN_MSG_HEADER)};
-    if(std::regex_match(skipped_msg_header, matches, getMsgMsgRegex()) && isValidDisplayNameLength(matches[1].length())
-            && isValidMsgContentLength(matches[2].length()))
-    {
-        if(!m_confirmed_server_messages.test(getMsgId(msg_msg)))
+        if(static_cast<unsigned> (datagram_count) < s_RECEIVE_BATCH_SIZE)
         {
-            outputIncomingMsg(matches[1], matches[2]);
+            break;
         }
-
-        return true;
     }
 
-    return false;
+    updateReceiveStats(datagrams_in_wakeup);
+    return Session_outcome::proceed();
 }
 
-void Udp_client::processServerMsgMsg(const std::string& msg_msg, unsigned msg_msg_length)
+void Udp_client::updateReceiveStats(unsigned datagrams_in_wakeup)
 {
-    if(isValidMsgMsg(msg_msg, msg_msg_length))
-    {
-        sendConfirmMsg(getMsgId(msg_msg));
-        return;
-    }
-
-    sendErrMsg("ERROR: received a malformed MSG message from the server.");
-}
-
-bool Udp_client::isValidMsgMsgLength(unsigned msg_msg_length) const
-{
-    return msg_msg_length >= s_BYTES_IN_MSG_HEADER + s_MIN_VARIABLE_DATA_LENGTH +
-        sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) + s_MIN_VARIABLE_DATA_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) &&
-            msg_msg_length <= s_BYTES_IN_MSG_HEADER + s_DISPLAY_NAME_MAX_LENGTH +
-                sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) + s_MSG_CONTENT_MAX_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR);
-}
+    m_receive_stats.datagram_count += datagrams_in_wakeup;
 
-void Udp_client::processServerPingMsg(const std::string& ping_msg, unsigned ping_msg_length)
-{
-    if(isValidPingMsgLength(ping_msg_length))
+    if(datagrams_in_wakeup > m_receive_stats.max_datagrams_per_wakeup)
     {
-        sendConfirmMsg(getMsgId(ping_msg));
-        return;
+        m_receive_stats.max_datagrams_per_wakeup = datagrams_in_wakeup;
     }
-
-    sendErrMsg("ERROR: received a malformed PING message from the server.");
 }
 
-bool Udp_client::isValidPingMsgLength(unsigned ping_msg_length) const
+char* Udp_client::getReceiveBuffer(unsigned index)
 {
-    return ping_msg_length == s_BYTES_IN_MSG_HEADER;
+    return m_receive_buffers.get() + index * s_RECEIVE_BUFFER_SIZE;
 }
 
-bool Udp_client::isValidByeMsg(const std::string& bye_msg, unsigned bye_msg_length) const
+Receive_stats Udp_client::getReceiveStats() const
 {
-    if(!isValidByeMsgLength(bye_msg_length) || static_cast<Protocol_msg_type> (static_cast<unsigned char> (bye_msg[0])) != Protocol_msg_type::M_BYE)
-    {
-        return false;
-    }
-
-    std::string skipped_msg_header{bye_msg.substr(s_BYTES_IN_MSG_HEADER)};
-    return std::regex_match(skipped_msg_header, getByeMsgRegex());
+    return m_receive_stats;
 }
 
-uint8_t Udp_client::processServerByeMsg(const std::string& bye_msg, unsigned bye_msg_length)
+void Udp_client::sendMsgToServer(Outbound_msg& msg)
 {
-    if(isValidByeMsg(bye_msg, bye_msg_length))
+    // Only CONFIRM messages consist of the header alone (a single part)
+    if(msg.getSize() == Udp_session::s_BYTES_IN_MSG_HEADER)
     {
-        sendConfirmMsg(getMsgId(bye_msg));
-        return 0;
+        stageConfirmMsg(msg);
+        return;
     }
 
-    sendErrMsg("ERROR: received a malformed BYE message from the server.");
-    return 2;
-}
-
-bool Udp_client::isValidByeMsgLength(unsigned bye_msg_length) const
-{
-    return bye_msg_length >= s_BYTES_IN_MSG_HEADER + s_MIN_VARIABLE_DATA_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) &&
-        bye_msg_length <= s_BYTES_IN_MSG_HEADER + s_DISPLAY_NAME_MAX_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR);
-}
-
-bool Udp_client::isValidErrMsg(const std::string& err_msg, unsigned err_msg_length) const
-{
-    if(!isValidErrMsgLength(err_msg_length) || static_cast<Protocol_msg_type> (static_cast<unsigned char> (err_msg[0])) != Protocol_msg_type::M_ERR)
+    // Keep the original order of outgoing messages
+    if(!flushConfirmMsgs())
     {
-        return false;
+        return;
     }
 
-    std::smatch matches{};
+    struct msghdr msg_header{};
+    msg_header.msg_iov = msg.getIovecs();
+    msg_header.msg_iovlen = msg.getPartCount();
 
-    std::string skipped_msg_header{err_msg.substr(s_BYTES_IN_MSG_HEADER)};
-    if(std::regex_match(skipped_msg_header, matches, getErrMsgRegex()) && isValidDisplayNameLength(matches[1].length())
-            && isValidMsgContentLength(matches[2].length()))
+    if(!m_is_socket_connected)
     {
-        printErrFromServer(matches[1], matches[2]);
-        return true;
+        msg_header.msg_name = m_args.getServerAddrStructAddress();
+        msg_header.msg_namelen = m_args.getSizeofServerAddrStruct();
     }
 
-    return false;
-}
-
-uint8_t Udp_client::processServerErrMsg(const std::string& err_msg, unsigned err_msg_length)
-{
-    if(isValidErrMsg(err_msg, err_msg_length))
+    // Failures are reported by errno instead of SIGPIPE, which would kill every session of the process
+    while(sendmsg(m_client_socket, &msg_header, MSG_NOSIGNAL) == -1)
     {
-        sendConfirmMsg(getMsgId(err_msg));
-        return 1;
+        // The error of an earlier datagram is reported once, this one hasn't been sent
+        if(errno != ECONNREFUSED)
+        {
+            setSendError(s_SEND_ERROR);
+            return;
+        }
     }
-
-    sendErrMsg("ERROR: received a malformed ERR message from the server.");
-    return 2;
 }
 
-bool Udp_client::isValidErrMsgLength(unsigned err_msg_length) const
+bool Udp_client::finishSending()
 {
-    return err_msg_length >= s_BYTES_IN_MSG_HEADER + s_MIN_VARIABLE_DATA_LENGTH +
-        sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) + s_MIN_VARIABLE_DATA_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) &&
-            err_msg_length <= s_BYTES_IN_MSG_HEADER + s_DISPLAY_NAME_MAX_LENGTH +
-                sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) + s_MSG_CONTENT_MAX_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR);
+    // A failure is recorded by setSendError(), datagrams are never queued
+    flushConfirmMsgs();
+    return true;
 }
 
-void Udp_client::processStdinEvent()
+void Udp_client::stageConfirmMsg(Outbound_msg& msg)
 {
-    // Check if stdin was closed
-    if(m_actual_event.events & EPOLLHUP)
-    {
-        sendByeMsgToServer();
-        return;
-    }
-
-    if(m_actual_event.events & EPOLLERR)
-    {
-        throw Exception{"stdin error occurred."};
-    }
-
-    // Handle stdin event
-    std::vector<std::string> user_input{parseUserInput()};
-
-    if(user_input.empty() || processNonMsgToServer(user_input))
-    {
-        return;
-    }
-
-    if(user_input[0] == m_user_commands[0])
+    if(m_staged_confirm_count == s_CONFIRM_BATCH_SIZE)
     {
-        m_user_display_name = user_input[3];
+        flushConfirmMsgs();
     }
 
-    buildUserMsgToServer(user_input);
-    sendMsgToServer();
+    // The session reuses its CONFIRM buffer for the next datagram, so the message is copied
+    const struct iovec& confirm_msg{msg.getIovecs()[0]};
+    std::memcpy(m_confirm_msgs[m_staged_confirm_count].data(), confirm_msg.iov_base, confirm_msg.iov_len);
 
-    if(user_input[0] == m_user_commands[0] && m_current_state == FSM_state::S_START)
+    // The server address may change before the batch is flushed (REPLY to AUTH), so it is copied; a connected socket
+    // doesn't need any address
+    if(m_is_socket_connected)
     {
-        m_current_state = FSM_state::S_AUTH;
+        m_confirm_headers[m_staged_confirm_count].msg_hdr.msg_namelen = 0;
     }
-
-    disableStdinEvents();
-    m_is_waiting_for_confirm = true;
-    m_is_waiting_for_reply = user_input[0] == m_user_commands[0] || user_input[0] == m_user_commands[2];
-    startTimer(m_args.getUdpConfirmTimeout());
-}
-
-void Udp_client::sendConfirmMsg(uint16_t ref_msg_id)
-{
-    std::string confirm_msg{std::string{static_cast<char> (Protocol_msg_type::M_CONFIRM)}};
-    uint16_t net_msg_id = htons(ref_msg_id);
-    confirm_msg.append(reinterpret_cast<const char*>(&net_msg_id), sizeof(net_msg_id));
-    if(sendto(m_client_socket, confirm_msg.data(), confirm_msg.size(), 0,
-        reinterpret_cast<struct sockaddr*>(m_args.getServerAddrStructAddress()), sizeof(*(m_args.getServerAddrStructAddress()))) == -1)
-    {
-        throw Exception{"couldn't send a message to the server: send() has failed."};
-    }
-    m_confirmed_server_messages.set(ref_msg_id);
-}
-
-void Udp_client::sendByeMsgToServer()
-{
-    buildByeMsg();
-    sendMsgToServer();
-    disableStdinEvents();
-    startTimer(m_args.getUdpConfirmTimeout()); // Time in ms
-    m_is_waiting_for_confirm = false;
-    m_is_waiting_for_reply = false;
-    m_is_waiting_for_bye_confirm = true;
-    m_allowed_retransmissions = m_args.getUdpMaxRetransCount();
-}
-
-// this function was generated by AI
-uint16_t Udp_client::getMsgId(std::string_view msg) const
-{
-    uint16_t msg_id{};
-    std::memcpy(&msg_id, msg.data() + s_BYTES_IN_PROTOCOL_MSG_TYPE, s_BYTES_IN_MSG_ID);
-    return ntohs(msg_id);
-}
-
-// this function was generated by AI
-uint16_t Udp_client::getRefMsgId(std::string_view reply_msg) const
-{
-    uint16_t ref_msg_id{};
-    std::memcpy(&ref_msg_id, reply_msg.data() + s_BYTES_IN_MSG_HEADER + s_BYTES_IN_REPLY_RESULT, s_BYTES_IN_MSG_ID);
-    return ntohs(ref_msg_id);
-}
-
-void Udp_client::sendMsgToServer()
-{
-    if(sendto(m_client_socket, m_msg_to_server.data(), m_msg_to_server.size(), 0,
-        reinterpret_cast<struct sockaddr*>(m_args.getServerAddrStructAddress()), sizeof(*(m_args.getServerAddrStructAddress()))) == -1)
+    else
     {
-        throw Exception{"couldn't send a message to the server: send() has failed."};
+        m_confirm_addrs[m_staged_confirm_count] = *(m_args.getServerAddrStructAddress());
+        m_confirm_headers[m_staged_confirm_count].msg_hdr.msg_namelen = m_args.getSizeofServerAddrStruct();
     }
+    ++m_staged_confirm_count;
 }
 
-void Udp_client::addMsgIdToMsgToServer(uint16_t msg_id)
-{
-    uint16_t net_id = htons(msg_id);
-    m_msg_to_server.append(reinterpret_cast<const char*>(&net_id), sizeof(net_id));
-}
-
-void Udp_client::buildErrMsg(std::string content)
+bool Udp_client::flushConfirmMsgs()
 {
-    m_msg_to_server = std::string{static_cast<char> (Protocol_msg_type::M_ERR)};
-    ++m_msg_to_server_id;
-    addMsgIdToMsgToServer(m_msg_to_server_id);
-    m_msg_to_server += m_user_display_name + s_VARIABLE_LENGTH_DATA_TERMINATOR + content + s_VARIABLE_LENGTH_DATA_TERMINATOR;
-}
-
-void Udp_client::buildAuthMsg(const std::string& username, const std::string& secret)
-{
-    m_msg_to_server = std::string{static_cast<char> (Protocol_msg_type::M_AUTH)};
-    addMsgIdToMsgToServer(m_msg_to_server_id);
-    m_msg_to_server += username + s_VARIABLE_LENGTH_DATA_TERMINATOR + m_user_display_name + s_VARIABLE_LENGTH_DATA_TERMINATOR
-        + secret + s_VARIABLE_LENGTH_DATA_TERMINATOR;
-}
-
-void Udp_client::buildJoinMsg(const std::string& channel_id)
-{
-    m_msg_to_server = std::string{static_cast<char> (Protocol_msg_type::M_JOIN)};
-    addMsgIdToMsgToServer(m_msg_to_server_id);
-    m_msg_to_server += channel_id + s_VARIABLE_LENGTH_DATA_TERMINATOR + m_user_display_name + s_VARIABLE_LENGTH_DATA_TERMINATOR;
-}
-
-void Udp_client::buildMsgMsg(const std::string& user_msg)
-{
-    m_msg_to_server = std::string{static_cast<char> (Protocol_msg_type::M_MSG)};
-    addMsgIdToMsgToServer(m_msg_to_server_id);
-    m_msg_to_server += m_user_display_name + s_VARIABLE_LENGTH_DATA_TERMINATOR + user_msg + s_VARIABLE_LENGTH_DATA_TERMINATOR;
-}
-
-void Udp_client::buildByeMsg()
-{
-    m_msg_to_server = std::string{static_cast<char> (Protocol_msg_type::M_BYE)};
-    ++m_msg_to_server_id;
-    addMsgIdToMsgToServer(m_msg_to_server_id);
-    m_msg_to_server += m_user_display_name + s_VARIABLE_LENGTH_DATA_TERMINATOR;
-}
+    unsigned sent_confirm_count{0};
 
-void Udp_client::processServerReplyMsg(const std::string& reply_msg, unsigned reply_msg_length, sockaddr_in& server_addr)
-{
-    if(m_current_state != FSM_state::S_AUTH && m_current_state != FSM_state::S_JOIN)
-    {
-        sendErrMsg("ERROR: received a REPLY message in unexpected state.");
-        return;
-    }
-
-    if(isValidReplyMsg(reply_msg, reply_msg_length))
+    while(sent_confirm_count < m_staged_confirm_count)
     {
-        if(m_current_state == FSM_state::S_AUTH)
-        {
-            *(m_args.getServerAddrStructAddress()) = server_addr;
-        }
+        const int result{sendmmsg(m_client_socket, m_confirm_headers.data() + sent_confirm_count,
+            m_staged_confirm_count - sent_confirm_count, MSG_NOSIGNAL)};
 
-        if(m_is_waiting_for_reply && m_msg_to_server_id - 1 == getRefMsgId(reply_msg))
+        if(result == -1)
         {
-            stopTimer();
-            uint16_t reply_msg_id{getMsgId(reply_msg)};
-            if(!m_confirmed_server_messages.test(reply_msg_id))
-            {
-                outputIncomingReply(reply_msg[s_BYTES_IN_MSG_HEADER], reply_msg.c_str() +
-                    s_BYTES_IN_MSG_HEADER + s_BYTES_IN_REPLY_RESULT + s_BYTES_IN_MSG_ID);
-            }
-
-            sendConfirmMsg(reply_msg_id);
-
-            if(m_current_state == FSM_state::S_JOIN || reply_msg[s_BYTES_IN_MSG_HEADER])
+            // The error of an earlier datagram is reported once, the staged ones haven't been sent
+            if(errno == ECONNREFUSED)
             {
-                m_current_state = FSM_state::S_OPEN;
+                continue;
             }
 
-            m_is_waiting_for_reply = false;
-            enableStdinEvents();
+            m_staged_confirm_count = 0;
+            setSendError(s_SEND_ERROR);
+            return false;
         }
 
-        return;
+        sent_confirm_count += result;
     }
 
-    sendErrMsg("ERROR: received a malformed REPLY message from the server.");
+    m_staged_confirm_count = 0;
+    return true;
 }
 
-
-bool Udp_client::isValidReplyMsgLength(unsigned reply_msg_length) const
-{
-    return reply_msg_length >= s_BYTES_IN_MSG_HEADER + s_BYTES_IN_REPLY_RESULT + s_BYTES_IN_MSG_ID +
-        s_MIN_VARIABLE_DATA_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR) && reply_msg_length <= s_BYTES_IN_PROTOCOL_MSG_TYPE
-            + s_BYTES_IN_MSG_ID + s_BYTES_IN_REPLY_RESULT + s_BYTES_IN_MSG_ID + s_MSG_CONTENT_MAX_LENGTH + sizeof(s_VARIABLE_LENGTH_DATA_TERMINATOR);
-}
-
-bool Udp_client::isValidReplyMsgResult(char reply_msg_result) const
-{
-    return reply_msg_result == 0 || reply_msg_result == 1;
-}
-
-bool Udp_client::isValidReplyMsg(const std::string& reply_msg, unsigned reply_msg_length) const
+Session_outcome Udp_client::followPeer()
 {
-    if(!isValidReplyMsgLength(reply_msg_length) || static_cast<Protocol_msg_type> (static_cast<unsigned char> (reply_msg[0])) != Protocol_msg_type::M_REPLY ||
-        !isValidReplyMsgResult(reply_msg[s_BYTES_IN_MSG_HEADER]))
+    // The server replies from its dynamic port, which is used for the rest of the session
+    if(m_is_socket_connected)
     {
-        return false;
+        return Session_outcome::proceed();
     }
 
-    std::smatch matches{};
-
-    std::string reply_msg_content{reply_msg.substr(s_BYTES_IN_MSG_HEADER + s_BYTES_IN_REPLY_RESULT + s_BYTES_IN_MSG_ID)};
-    return std::regex_match(reply_msg_content, matches, getPrintableCharsSpaceLfAndTerminatorRegex());
-}
-
-const std::regex& Udp_client::getErrMsgRegex()
-{
-    static const std::regex value{
-        getPrintableChars()
-        + getEscapedVariableLengthTerminator()
-        + getPrintableCharsSpaceLf()
-        + getEscapedVariableLengthTerminator()
-    };
-
-    return value;
-}
+    *(m_args.getServerAddrStructAddress()) = *m_datagram_addr;
 
-const std::regex& Udp_client::getMsgMsgRegex()
-{
-    return getErrMsgRegex();
-}
+    if(connect(m_client_socket, reinterpret_cast<const struct sockaddr*>(m_datagram_addr),
+               getSocketAddressLength(*m_datagram_addr)) != 0)
+    {
+        return Session_outcome::fail("couldn't connect the client socket to the server: connect() has failed.");
+    }
 
-const std::regex& Udp_client::getByeMsgRegex()
-{
-    static const std::regex value{getPrintableChars()+ getEscapedVariableLengthTerminator()};
-    return value;
+    m_is_socket_connected = true;
+    return Session_outcome::proceed();
 }
 
-const std::regex& Udp_client::getPrintableCharsAndTerminatorRegex()
+bool Udp_client::clearSocketError()
 {
-    static const std::regex value{Client::getPrintableChars() + getEscapedVariableLengthTerminator()};
-    return value;
-}
+    int socket_error{0};
+    socklen_t socket_error_size{sizeof(socket_error)};
 
-const std::regex& Udp_client::getPrintableCharsSpaceLfAndTerminatorRegex()
-{
-    static const std::regex value{Client::getPrintableCharsSpaceLf() + getEscapedVariableLengthTerminator()};
-    return value;
-}
+    if(getsockopt(m_client_socket, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_size) != 0)
+    {
+        return false;
+    }
 
-// this function was generated by AI
-const std::string& Udp_client::getEscapedVariableLengthTerminator()
-{
-    static const std::string value = [] {
-        std::ostringstream oss;
-        oss << "\\x" << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(static_cast<unsigned char>(s_VARIABLE_LENGTH_DATA_TERMINATOR));
-        return oss.str();
-    }();
-
-    return value;
+    return socket_error == 0 || socket_error == ECONNREFUSED;
 }
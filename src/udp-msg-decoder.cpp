@@ -0,0 +1,128 @@
+/**
+ * @file udp-msg-decoder.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the decoder of datagrams received by the UDP version of IPK25-CHAT client.
+ */
+
+#include "udp-msg-decoder.h"
+#include "udp-session.h"
+#include "char-class.h"
+#include <arpa/inet.h> // ntohs()
+#include <cstring>     // std::memchr(), std::memcpy()
+
+Udp_server_msg Udp_msg_decoder::decode(std::string_view datagram)
+{
+    Udp_server_msg msg{};
+
+    if(datagram.empty())
+    {
+        return msg;
+    }
+
+    const unsigned char type_byte{static_cast<unsigned char> (datagram[0])};
+    const Msg_layout& layout{getLayouts()[type_byte]};
+
+    if(!layout.is_expected)
+    {
+        return msg;
+    }
+
+    msg.type = static_cast<Protocol_msg_type> (type_byte);
+
+    if(datagram.size() < layout.min_length || datagram.size() > layout.max_length)
+    {
+        return msg;
+    }
+
+    if(msg.type == Protocol_msg_type::M_CONFIRM)
+    {
+        msg.ref_msg_id = readUint16(datagram, Udp_session::s_BYTES_IN_PROTOCOL_MSG_TYPE);
+    }
+    else
+    {
+        msg.msg_id = readUint16(datagram, Udp_session::s_BYTES_IN_PROTOCOL_MSG_TYPE);
+    }
+
+    if(msg.type == Protocol_msg_type::M_REPLY)
+    {
+        const char result{datagram[Udp_session::s_BYTES_IN_MSG_HEADER]};
+
+        if(result != 0 && result != 1)
+        {
+            return msg;
+        }
+
+        msg.is_positive_reply = result == 1;
+        msg.ref_msg_id = readUint16(datagram, Udp_session::s_BYTES_IN_MSG_HEADER + Udp_session::s_BYTES_IN_REPLY_RESULT);
+    }
+
+    std::string_view rest{datagram.substr(layout.fixed_part_length)};
+
+    for(uint8_t i{0}; i < layout.variable_field_count; ++i)
+    {
+        const void* terminator{std::memchr(rest.data(), Udp_session::s_VARIABLE_LENGTH_DATA_TERMINATOR, rest.size())};
+
+        if(terminator == nullptr)
+        {
+            return msg;
+        }
+
+        const std::string_view field{rest.substr(0, static_cast<const char*> (terminator) - rest.data())};
+
+        if(!Char_class::isAll(field, layout.field_classes[i]))
+        {
+            return msg;
+        }
+
+        msg.*layout.field_targets[i] = field;
+        rest.remove_prefix(field.size() + sizeof(Udp_session::s_VARIABLE_LENGTH_DATA_TERMINATOR));
+    }
+
+    msg.is_valid = rest.empty();
+    return msg;
+}
+
+const std::array<Udp_msg_decoder::Msg_layout, 256>& Udp_msg_decoder::getLayouts()
+{
+    static const std::array<Msg_layout, 256> value{[] {
+        constexpr unsigned header{Udp_session::s_BYTES_IN_MSG_HEADER};
+        constexpr unsigned terminator{sizeof(Udp_session::s_VARIABLE_LENGTH_DATA_TERMINATOR)};
+        constexpr unsigned min_data{Udp_session::s_MIN_VARIABLE_DATA_LENGTH};
+        constexpr unsigned reply_header{header + Udp_session::s_BYTES_IN_REPLY_RESULT + Udp_session::s_BYTES_IN_MSG_ID};
+
+        std::array<Msg_layout, 256> layouts{};
+
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_CONFIRM)] = {true, header, header, header, 0, {}, {}};
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_PING)] = {true, header, header, header, 0, {}, {}};
+
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_BYE)] = {true,
+            header + min_data + terminator,
+            header + Udp_session::s_DISPLAY_NAME_MAX_LENGTH + terminator,
+            header, 1, {Char_class::s_PRINTABLE, 0}, {&Udp_server_msg::display_name, nullptr}};
+
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_MSG)] = {true,
+            header + min_data + terminator + min_data + terminator,
+            header + Udp_session::s_DISPLAY_NAME_MAX_LENGTH + terminator + Udp_session::s_MSG_CONTENT_MAX_LENGTH + terminator,
+            header, 2, {Char_class::s_PRINTABLE, Char_class::s_PRINTABLE_SPACE_LF},
+            {&Udp_server_msg::display_name, &Udp_server_msg::content}};
+
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_ERR)] =
+            layouts[static_cast<unsigned char> (Protocol_msg_type::M_MSG)];
+
+        layouts[static_cast<unsigned char> (Protocol_msg_type::M_REPLY)] = {true,
+            reply_header + min_data + terminator,
+            reply_header + Udp_session::s_MSG_CONTENT_MAX_LENGTH + terminator,
+            static_cast<uint8_t> (reply_header), 1, {Char_class::s_PRINTABLE_SPACE_LF, 0}, {&Udp_server_msg::content, nullptr}};
+
+        return layouts;
+    }()};
+
+    return value;
+}
+
+uint16_t Udp_msg_decoder::readUint16(std::string_view datagram, std::size_t offset)
+{
+    uint16_t value{};
+    std::memcpy(&value, datagram.data() + offset, sizeof(value));
+    return ntohs(value);
+}
@@ -0,0 +1,493 @@
+/**
+ * @file udp-session.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the protocol core of the UDP version of IPK25-CHAT client.
+ */
+
+#include "udp-session.h"
+#include <cstring>
+#include <arpa/inet.h> // htons()
+
+Udp_session::Udp_session(const Session_config& config, Clock::time_point now)
+    :
+    Protocol_session{now},
+    m_config{config},
+    m_retransmission_queue{config.udp_window_size},
+    m_rtt_estimator{config.udp_confirm_timeout, config.udp_min_confirm_timeout, config.udp_max_confirm_timeout}
+{
+}
+
+const Action_list& Udp_session::processDatagram(std::string_view datagram, Clock::time_point now)
+{
+    if(!beginCall(now))
+    {
+        return endCall();
+    }
+
+    if(datagram.size() > s_MAX_MSG_SIZE)
+    {
+        sendErrMsg("ERROR: too long message from server.");
+        return endCall();
+    }
+
+    processMessageFromServer(Udp_msg_decoder::decode(datagram));
+    return endCall();
+}
+
+bool Udp_session::isUserInputEnabled() const
+{
+    return !isClosed() && !m_is_terminating && !m_is_waiting_for_reply && !m_retransmission_queue.isFull();
+}
+
+void Udp_session::processMessageFromServer(const Udp_server_msg& msg_from_server)
+{
+    if(msg_from_server.type == Protocol_msg_type::M_BYE)
+    {
+        processServerByeMsg(msg_from_server);
+        return;
+    }
+
+    if(msg_from_server.type == Protocol_msg_type::M_ERR)
+    {
+        processServerErrMsg(msg_from_server);
+        return;
+    }
+
+    switch(m_current_state)
+    {
+        case FSM_state::S_START:
+            switch(msg_from_server.type)
+            {
+                case Protocol_msg_type::M_CONFIRM:
+                    processServerConfirmMsg(msg_from_server);
+                    break;
+
+                default:
+                    sendErrMsg("ERROR: only messages of types BYE, ERR or CONFIRM are expected to be received"
+                        " from the server in the client's START state.");
+                    break;
+            }
+            break;
+        case FSM_state::S_AUTH:
+            switch(msg_from_server.type)
+            {
+                case Protocol_msg_type::M_CONFIRM:
+                    processServerConfirmMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_REPLY:
+                    processServerReplyMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_PING:
+                    processServerPingMsg(msg_from_server);
+                    break;
+
+                default:
+                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING and REPLY are expected to be received"
+                        " from the server in the client's AUTH state.");
+                    break;
+            }
+            break;
+        case FSM_state::S_OPEN:
+            switch(msg_from_server.type)
+            {
+                case Protocol_msg_type::M_CONFIRM:
+                    processServerConfirmMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_MSG:
+                    processServerMsgMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_PING:
+                    processServerPingMsg(msg_from_server);
+                    break;
+
+                default:
+                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING, JOIN and MSG are expected to be received"
+                        " from the server in the client's OPEN state.");
+                    break;
+            }
+            break;
+
+        case FSM_state::S_JOIN:
+            switch(msg_from_server.type)
+            {
+                case Protocol_msg_type::M_MSG:
+                    processServerMsgMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_PING:
+                    processServerPingMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_REPLY:
+                    processServerReplyMsg(msg_from_server);
+                    break;
+
+                case Protocol_msg_type::M_CONFIRM:
+                    processServerConfirmMsg(msg_from_server);
+                    break;
+
+                default:
+                    sendErrMsg("ERROR: only messages of types BYE, ERR, CONFIRM, PING, REPLY and MSG are expected to be received"
+                        " from the server in the client's JOIN state.");
+                    break;
+            }
+            break;
+
+        default:
+            sendErrMsg("ERROR: invalid client's FSM state.");
+            break;
+    }
+}
+
+void Udp_session::processServerConfirmMsg(const Udp_server_msg& confirm_msg)
+{
+    if(!confirm_msg.is_valid)
+    {
+        sendErrMsg("ERROR: received a malformed CONFIRM message from the server.");
+        return;
+    }
+
+    // Duplicate CONFIRMs and CONFIRMs of messages superseded by ERR or BYE are ignored
+    const Pending_msg* confirmed_msg{m_retransmission_queue.retire(confirm_msg.ref_msg_id)};
+
+    if(confirmed_msg == nullptr)
+    {
+        return;
+    }
+
+    Timer_wheel::Timer_handle retransmission_timer{confirmed_msg->timer};
+    stopTimer(retransmission_timer);
+
+    // Karn's algorithm: it isn't known which copy of a retransmitted message has been confirmed
+    if(confirmed_msg->retransmissions_left == m_config.udp_max_retransmissions)
+    {
+        m_rtt_estimator.addSample(getNow() - confirmed_msg->sent_at);
+    }
+
+    switch(confirmed_msg->type)
+    {
+        case Protocol_msg_type::M_BYE:
+            addCloseAction(true, "");
+            break;
+
+        case Protocol_msg_type::M_ERR:
+            addCloseAction(false, "");
+            break;
+
+        case Protocol_msg_type::M_AUTH:
+            if(m_current_state == FSM_state::S_AUTH)
+            {
+                startReplyWait();
+            }
+            break;
+
+        case Protocol_msg_type::M_JOIN:
+            if(m_current_state == FSM_state::S_OPEN)
+            {
+                m_current_state = FSM_state::S_JOIN;
+                startReplyWait();
+            }
+            break;
+
+        default: // MSG only frees a slot in the window
+            break;
+    }
+}
+
+std::chrono::milliseconds Udp_session::getConfirmTimeout() const
+{
+    if(m_config.is_udp_confirm_timeout_fixed)
+    {
+        return m_config.udp_confirm_timeout;
+    }
+
+    return m_rtt_estimator.getRto();
+}
+
+void Udp_session::startReplyWait()
+{
+    m_reply_timer = startTimer({Timer_kind::T_REPLY, m_reply_ref_msg_id}, std::chrono::seconds{s_MAX_REPLY_WAIT_TIME});
+}
+
+void Udp_session::sendErrMsg(std::string_view err_msg)
+{
+    buildErrMsg(err_msg);
+    addPrintErrorAction(err_msg.substr(strlen("ERROR: ")));
+    terminate();
+}
+
+void Udp_session::terminate()
+{
+    // Messages still waiting for a CONFIRM are superseded by the ERR or BYE message
+    for(Pending_msg& pending_msg : m_retransmission_queue)
+    {
+        stopTimer(pending_msg.timer);
+    }
+
+    m_retransmission_queue.clear();
+    m_is_terminating = true;
+    m_is_waiting_for_reply = false;
+    stopTimer(m_reply_timer);
+    sendMsgToServer();
+}
+
+void Udp_session::processInterrupt()
+{
+    buildByeMsg();
+    terminate();
+}
+
+void Udp_session::processEof()
+{
+    // BYE may have already been sent because of SIGINT
+    if(!m_is_terminating)
+    {
+        buildByeMsg();
+        terminate();
+    }
+}
+
+void Udp_session::processTransportFailure(const char* reason)
+{
+    // The ERR message refers to the content until it is sent, so it has to outlive the call
+    m_transport_err_msg.assign("ERROR: ").append(reason);
+    sendErrMsg(m_transport_err_msg);
+}
+
+void Udp_session::processTimerEvent(Timer_name name)
+{
+    if(name.kind == Timer_kind::T_REPLY)
+    {
+        sendErrMsg("ERROR: waited too long for the server's reply.");
+        return;
+    }
+
+    // The message may have been dropped by an ERR or BYE sent because of a timer expired at the same time
+    Pending_msg* pending_msg{m_retransmission_queue.find(name.msg_id)};
+
+    if(pending_msg == nullptr)
+    {
+        return;
+    }
+
+    if(pending_msg->retransmissions_left == 0)
+    {
+        addCloseAction(false, "exceeded udp max retransmission number.");
+        return;
+    }
+
+    m_rtt_estimator.backOff();
+    Outbound_msg retransmission{};
+    retransmission.assign({pending_msg->msg});
+    addSendAction(retransmission);
+    pending_msg->timer = startTimer(name, getConfirmTimeout());
+    --pending_msg->retransmissions_left;
+}
+
+void Udp_session::forgetExpiredTimer(Timer_name name)
+{
+    Protocol_session::forgetExpiredTimer(name);
+
+    if(name.kind != Timer_kind::T_RETRANSMISSION)
+    {
+        return;
+    }
+
+    if(Pending_msg* pending_msg{m_retransmission_queue.find(name.msg_id)})
+    {
+        pending_msg->timer = Timer_wheel::s_INVALID_HANDLE;
+    }
+}
+
+void Udp_session::processServerMsgMsg(const Udp_server_msg& msg_msg)
+{
+    if(msg_msg.is_valid && isValidDisplayNameLength(msg_msg.display_name.length())
+        && isValidMsgContentLength(msg_msg.content.length()))
+    {
+        if(!m_confirmed_server_messages.contains(msg_msg.msg_id))
+        {
+            outputIncomingMsg(msg_msg.display_name, msg_msg.content);
+        }
+
+        sendConfirmMsg(msg_msg.msg_id);
+        return;
+    }
+
+    sendErrMsg("ERROR: received a malformed MSG message from the server.");
+}
+
+void Udp_session::processServerPingMsg(const Udp_server_msg& ping_msg)
+{
+    if(ping_msg.is_valid)
+    {
+        sendConfirmMsg(ping_msg.msg_id);
+        return;
+    }
+
+    sendErrMsg("ERROR: received a malformed PING message from the server.");
+}
+
+void Udp_session::processServerByeMsg(const Udp_server_msg& bye_msg)
+{
+    if(bye_msg.is_valid)
+    {
+        sendConfirmMsg(bye_msg.msg_id);
+        addCloseAction(true, "");
+        return;
+    }
+
+    sendErrMsg("ERROR: received a malformed BYE message from the server.");
+}
+
+void Udp_session::processServerErrMsg(const Udp_server_msg& err_msg)
+{
+    if(err_msg.is_valid && isValidDisplayNameLength(err_msg.display_name.length())
+        && isValidMsgContentLength(err_msg.content.length()))
+    {
+        printErrFromServer(err_msg.display_name, err_msg.content);
+        sendConfirmMsg(err_msg.msg_id);
+        addCloseAction(false, "");
+        return;
+    }
+
+    sendErrMsg("ERROR: received a malformed ERR message from the server.");
+}
+
+void Udp_session::processUserInput(const User_input& user_input)
+{
+    if(user_input.type == User_input_type::U_AUTH)
+    {
+        m_user_display_name = user_input.display_name;
+    }
+
+    if(!buildUserMsgToServer(user_input))
+    {
+        return;
+    }
+
+    if(user_input.type == User_input_type::U_AUTH || user_input.type == User_input_type::U_JOIN)
+    {
+        // AUTH and JOIN block user input until the REPLY arrives, regardless of the window size
+        m_is_waiting_for_reply = true;
+        m_reply_ref_msg_id = m_msg_to_server_id;
+    }
+
+    sendMsgToServer();
+
+    if(user_input.type == User_input_type::U_AUTH && m_current_state == FSM_state::S_START)
+    {
+        m_current_state = FSM_state::S_AUTH;
+    }
+}
+
+void Udp_session::sendConfirmMsg(uint16_t ref_msg_id)
+{
+    // A datagram is confirmed at most once, so a single CONFIRM buffer is enough for one call
+    const uint16_t net_msg_id{htons(ref_msg_id)};
+    m_confirm_msg[0] = static_cast<char> (Protocol_msg_type::M_CONFIRM);
+    std::memcpy(m_confirm_msg.data() + s_BYTES_IN_PROTOCOL_MSG_TYPE, &net_msg_id, sizeof(net_msg_id));
+
+    Outbound_msg confirm_msg{};
+    confirm_msg.assign({{m_confirm_msg.data(), m_confirm_msg.size()}});
+    addSendAction(confirm_msg);
+    m_confirmed_server_messages.insert(ref_msg_id);
+}
+
+void Udp_session::sendMsgToServer()
+{
+    addSendAction();
+
+    // The only contiguous copy is kept for retransmission; the slot keeps the capacity of its previous message,
+    // so the copy doesn't allocate in the steady state
+    Pending_msg& pending_msg{m_retransmission_queue.push()};
+    m_msg_to_server.copyTo(pending_msg.msg);
+    pending_msg.msg_id = m_msg_to_server_id;
+    pending_msg.type = static_cast<Protocol_msg_type> (static_cast<unsigned char> (m_msg_to_server_header[0]));
+    pending_msg.timer = startTimer({Timer_kind::T_RETRANSMISSION, m_msg_to_server_id}, getConfirmTimeout());
+    pending_msg.sent_at = getNow();
+    pending_msg.retransmissions_left = m_config.udp_max_retransmissions;
+    ++m_msg_to_server_id;
+}
+
+std::string_view Udp_session::encodeMsgHeader(Protocol_msg_type type)
+{
+    const uint16_t net_msg_id{htons(m_msg_to_server_id)};
+    m_msg_to_server_header[0] = static_cast<char> (type);
+    std::memcpy(m_msg_to_server_header.data() + s_BYTES_IN_PROTOCOL_MSG_TYPE, &net_msg_id, sizeof(net_msg_id));
+    return {m_msg_to_server_header.data(), m_msg_to_server_header.size()};
+}
+
+void Udp_session::buildErrMsg(std::string_view content)
+{
+    m_msg_to_server.assign({encodeMsgHeader(Protocol_msg_type::M_ERR), m_user_display_name, s_VARIABLE_LENGTH_DATA_END,
+        content, s_VARIABLE_LENGTH_DATA_END});
+}
+
+void Udp_session::buildAuthMsg(std::string_view username, std::string_view secret)
+{
+    m_msg_to_server.assign({encodeMsgHeader(Protocol_msg_type::M_AUTH), username, s_VARIABLE_LENGTH_DATA_END,
+        m_user_display_name, s_VARIABLE_LENGTH_DATA_END, secret, s_VARIABLE_LENGTH_DATA_END});
+}
+
+void Udp_session::buildJoinMsg(std::string_view channel_id)
+{
+    m_msg_to_server.assign({encodeMsgHeader(Protocol_msg_type::M_JOIN), channel_id, s_VARIABLE_LENGTH_DATA_END,
+        m_user_display_name, s_VARIABLE_LENGTH_DATA_END});
+}
+
+void Udp_session::buildMsgMsg(std::string_view user_msg)
+{
+    m_msg_to_server.assign({encodeMsgHeader(Protocol_msg_type::M_MSG), m_user_display_name, s_VARIABLE_LENGTH_DATA_END,
+        user_msg, s_VARIABLE_LENGTH_DATA_END});
+}
+
+void Udp_session::buildByeMsg()
+{
+    m_msg_to_server.assign({encodeMsgHeader(Protocol_msg_type::M_BYE), m_user_display_name, s_VARIABLE_LENGTH_DATA_END});
+}
+
+void Udp_session::processServerReplyMsg(const Udp_server_msg& reply_msg)
+{
+    if(m_current_state != FSM_state::S_AUTH && m_current_state != FSM_state::S_JOIN)
+    {
+        sendErrMsg("ERROR: received a REPLY message in unexpected state.");
+        return;
+    }
+
+    if(!reply_msg.is_valid)
+    {
+        sendErrMsg("ERROR: received a malformed REPLY message from the server.");
+        return;
+    }
+
+    // The server replies from its dynamic port, which is used for the rest of the session
+    if(m_current_state == FSM_state::S_AUTH && !m_is_peer_followed)
+    {
+        addFollowPeerAction();
+        m_is_peer_followed = true;
+    }
+
+    // The REPLY is accepted only after the CONFIRM of the request it refers to
+    if(m_is_waiting_for_reply && m_reply_ref_msg_id == reply_msg.ref_msg_id
+       && !m_retransmission_queue.contains(m_reply_ref_msg_id))
+    {
+        stopTimer(m_reply_timer);
+        if(!m_confirmed_server_messages.contains(reply_msg.msg_id))
+        {
+            outputIncomingReply(reply_msg.is_positive_reply, reply_msg.content);
+        }
+
+        sendConfirmMsg(reply_msg.msg_id);
+
+        if(m_current_state == FSM_state::S_JOIN || reply_msg.is_positive_reply)
+        {
+            m_current_state = FSM_state::S_OPEN;
+        }
+
+        m_is_waiting_for_reply = false;
+    }
+}
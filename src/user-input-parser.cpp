@@ -0,0 +1,99 @@
+/**
+ * @file user-input-parser.cpp
+ * @author Andrii Klymenko
+ * @brief Implementation of the parser of the user's commands and chat messages.
+ */
+
+#include "user-input-parser.h"
+#include "char-class.h"
+
+User_input User_input_parser::parse(std::string_view line)
+{
+    User_input result{};
+
+    if(line.empty())
+    {
+        return result;
+    }
+
+    // chat messages are the common case and are recognized by the first byte
+    if(line[0] != '/')
+    {
+        if(Char_class::isAll(line, Char_class::s_PRINTABLE_SPACE_LF))
+        {
+            result.type = User_input_type::U_MSG;
+            result.content = line;
+        }
+
+        return result;
+    }
+
+    std::string_view rest{line};
+    bool is_valid{false};
+
+    switch(line.size() > 1 ? line[1] : '\0')
+    {
+        case 'a':
+            is_valid = consumeKeyword(rest, "/auth ")
+                && consumeField(rest, Char_class::s_ALPHANUMERIC_UNDERLINE_DASH, result.username)
+                && consumeKeyword(rest, " ")
+                && consumeField(rest, Char_class::s_ALPHANUMERIC_UNDERLINE_DASH, result.secret)
+                && consumeKeyword(rest, " ")
+                && consumeField(rest, Char_class::s_PRINTABLE, result.display_name);
+            result.type = User_input_type::U_AUTH;
+            break;
+
+        case 'j':
+            is_valid = consumeKeyword(rest, "/join ")
+                && consumeField(rest, Char_class::s_ALPHANUMERIC_UNDERLINE_DASH, result.channel_id);
+            result.type = User_input_type::U_JOIN;
+            break;
+
+        case 'r':
+            is_valid = consumeKeyword(rest, "/rename ")
+                && consumeField(rest, Char_class::s_PRINTABLE, result.display_name);
+            result.type = User_input_type::U_RENAME;
+            break;
+
+        case 'h':
+            is_valid = consumeKeyword(rest, "/help");
+            result.type = User_input_type::U_HELP;
+            break;
+
+        default:
+            break;
+    }
+
+    // the whole line has to be consumed
+    if(!is_valid || !rest.empty())
+    {
+        return User_input{};
+    }
+
+    return result;
+}
+
+bool User_input_parser::consumeKeyword(std::string_view& line, std::string_view keyword)
+{
+    if(!line.starts_with(keyword))
+    {
+        return false;
+    }
+
+    line.remove_prefix(keyword.size());
+    return true;
+}
+
+bool User_input_parser::consumeField(std::string_view& line, uint8_t char_class, std::string_view& field)
+{
+    const std::size_t length{Char_class::span(line, char_class)};
+
+    if(length == 0)
+    {
+        return false;
+    }
+
+    field = line.substr(0, length);
+    line.remove_prefix(length);
+    return true;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file alloc-free-encoding-test.cpp
+ * @author Andrii Klymenko
+ * @brief Checks that sending chat messages doesn't allocate memory once a session has warmed up.
+ *
+ * Every operator new of the process is counted. A TCP and a UDP session are authenticated, warmed up by a few chat
+ * messages and then fed with many more; building and sending them (including the UDP CONFIRMs and the retransmission
+ * timers) must not allocate at all. Built and run by `make test`.
+ */
+
+#include "tcp-session.h"
+#include "udp-session.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int s_WARM_UP_MSG_COUNT{100};
+    constexpr int s_MEASURED_MSG_COUNT{10000};
+
+    bool s_is_counting{false};         ///< True while allocations are counted.
+    std::size_t s_allocation_count{0}; ///< Allocations made while counting.
+
+    using Clock = Protocol_session::Clock;
+
+    /**
+     * @brief Finds the message to the server among the actions.
+     * @param actions Actions returned by the session.
+     * @return The message, or nullptr if nothing is sent.
+     */
+    Outbound_msg* findSentMsg(const Action_list& actions)
+    {
+        for(const Protocol_action& action : actions)
+        {
+            if(action.type == Action_type::A_SEND)
+            {
+                return const_cast<Outbound_msg*> (&action.msg);
+            }
+        }
+
+        return nullptr;
+    }
+
+    /// @return True if the actions close the session.
+    bool isClosed(const Action_list& actions)
+    {
+        return !actions.empty() && actions.back().type == Action_type::A_CLOSE;
+    }
+
+    /**
+     * @brief Sends chat messages through a TCP session.
+     * @param session Authenticated session.
+     * @param lines Lines of user input.
+     * @param count Number of messages to send.
+     * @param now Current time.
+     * @return False if the session hasn't sent a message.
+     */
+    bool sendTcpMsgs(Tcp_session& session, const std::vector<std::string>& lines, int count, Clock::time_point now)
+    {
+        for(int i{0}; i < count; ++i)
+        {
+            const Action_list& actions{session.processUserLine(lines[i % lines.size()], now)};
+
+            if(findSentMsg(actions) == nullptr || isClosed(actions))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Sends chat messages through a UDP session and confirms each of them.
+     * @param session Authenticated session.
+     * @param lines Lines of user input.
+     * @param count Number of messages to send.
+     * @param now Current time, advanced by every message.
+     * @return False if the session hasn't sent a message.
+     */
+    bool sendUdpMsgs(Udp_session& session, const std::vector<std::string>& lines, int count, Clock::time_point& now)
+    {
+        char confirm[Udp_session::s_BYTES_IN_MSG_HEADER]{};
+
+        for(int i{0}; i < count; ++i)
+        {
+            now += std::chrono::milliseconds{1};
+            Outbound_msg* msg{findSentMsg(session.processUserLine(lines[i % lines.size()], now))};
+
+            if(msg == nullptr)
+            {
+                return false;
+            }
+
+            // CONFIRM carries the MessageID of the confirmed message
+            const char* header{static_cast<const char*> (msg->getIovecs()[0].iov_base)};
+            confirm[0] = static_cast<char> (Protocol_msg_type::M_CONFIRM);
+            confirm[1] = header[1];
+            confirm[2] = header[2];
+
+            now += std::chrono::milliseconds{1};
+
+            if(isClosed(session.processDatagram({confirm, sizeof(confirm)}, now)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Reports the result of one check.
+     * @param name Name of the check.
+     * @param is_passed True if the messages have been sent.
+     * @param allocation_count Allocations made while sending them.
+     * @return True if the check has passed.
+     */
+    bool report(const char* name, bool is_passed, std::size_t allocation_count)
+    {
+        const bool is_ok{is_passed && allocation_count == 0};
+        std::printf("%s: %d messages, %zu allocations: %s\n", name, s_MEASURED_MSG_COUNT, allocation_count,
+                    is_ok ? "OK" : "FAILED");
+        return is_ok;
+    }
+
+    /**
+     * @brief Authenticates a TCP session and measures sending chat messages.
+     * @param lines Lines of user input.
+     * @return True if no allocation has been made.
+     */
+    bool testTcp(const std::vector<std::string>& lines)
+    {
+        const Clock::time_point now{Clock::now()};
+        Tcp_session session{now};
+
+        session.processUserLine("/auth user secret name", now);
+        session.processReceived(std::string_view{"REPLY OK IS welcome\r\n"}, now);
+
+        bool is_passed{sendTcpMsgs(session, lines, s_WARM_UP_MSG_COUNT, now)};
+
+        s_allocation_count = 0;
+        s_is_counting = true;
+        is_passed = is_passed && sendTcpMsgs(session, lines, s_MEASURED_MSG_COUNT, now);
+        s_is_counting = false;
+
+        return report("TCP", is_passed, s_allocation_count);
+    }
+
+    /**
+     * @brief Authenticates a UDP session and measures sending and confirming chat messages.
+     * @param lines Lines of user input.
+     * @return True if no allocation has been made.
+     */
+    bool testUdp(const std::vector<std::string>& lines)
+    {
+        Clock::time_point now{Clock::now()};
+        Udp_session session{Session_config{}, now};
+
+        // CONFIRM and REPLY to AUTH (MessageID 0)
+        session.processUserLine("/auth user secret name", now);
+        session.processDatagram(std::string_view{"\x00\x00\x00", 3}, now);
+        session.processDatagram(std::string_view{"\x01\x00\x00\x01\x00\x00ok\x00", 9}, now);
+
+        bool is_passed{sendUdpMsgs(session, lines, s_WARM_UP_MSG_COUNT, now)};
+
+        s_allocation_count = 0;
+        s_is_counting = true;
+        is_passed = is_passed && sendUdpMsgs(session, lines, s_MEASURED_MSG_COUNT, now);
+        s_is_counting = false;
+
+        return report("UDP", is_passed, s_allocation_count);
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if(s_is_counting)
+    {
+        ++s_allocation_count;
+    }
+
+    if(void* memory{std::malloc(size == 0 ? 1 : size)})
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main()
+{
+    // lines of different lengths, so that the buffers have to fit the longest of them
+    const std::vector<std::string> lines{"hello", std::string(1000, 'a'), "how are you?", std::string(60000, 'b')};
+
+    const bool is_tcp_ok{testTcp(lines)};
+    const bool is_udp_ok{testUdp(lines)};
+
+    return is_tcp_ok && is_udp_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file timer-wheel-test.cpp
+ * @author Andrii Klymenko
+ * @brief Checks that cancelling a timer that has already expired doesn't corrupt the timer wheel.
+ *
+ * The handles kept by the sessions (retransmissions, REPLY and connection timers) may be cancelled after their timer
+ * has expired, possibly after its node has been reused by another timer. Built and run by `make test`.
+ */
+
+#include "timer-wheel.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    using Clock = Timer_wheel::Clock;
+
+    /**
+     * @brief Reports the result of one check.
+     * @param name Name of the check.
+     * @param is_ok True if the check has passed.
+     * @return is_ok.
+     */
+    bool report(const char* name, bool is_ok)
+    {
+        std::printf("%s: %s\n", name, is_ok ? "OK" : "FAILED");
+        return is_ok;
+    }
+
+    /**
+     * @brief Expires two timers, cancels one of them and schedules two more timers.
+     * @return True if the new timers have different handles and both of them expire.
+     */
+    bool testCancelAfterExpiration()
+    {
+        const Clock::time_point start{Clock::now()};
+        Timer_wheel wheel{start};
+        std::vector<Timer_name> expired{};
+
+        Timer_wheel::Timer_handle a{wheel.schedule(start + std::chrono::milliseconds{1}, {Timer_kind::T_REPLY, 1})};
+        wheel.schedule(start + std::chrono::milliseconds{1}, {Timer_kind::T_REPLY, 2});
+        wheel.expire(start + std::chrono::milliseconds{10}, expired);
+
+        wheel.cancel(a);
+
+        const Timer_wheel::Timer_handle c{wheel.schedule(start + std::chrono::milliseconds{20}, {Timer_kind::T_REPLY, 3})};
+        const Timer_wheel::Timer_handle d{wheel.schedule(start + std::chrono::milliseconds{20}, {Timer_kind::T_REPLY, 4})};
+
+        expired.clear();
+        wheel.expire(start + std::chrono::milliseconds{30}, expired);
+
+        return a == Timer_wheel::s_INVALID_HANDLE && c != d && expired.size() == 2 && !wheel.getEarliestDeadline();
+    }
+
+    /**
+     * @brief Cancels the handle of an expired timer whose node has been reused by a new timer.
+     * @return True if the new timer still expires.
+     */
+    bool testCancelOfReusedNode()
+    {
+        const Clock::time_point start{Clock::now()};
+        Timer_wheel wheel{start};
+        std::vector<Timer_name> expired{};
+
+        Timer_wheel::Timer_handle stale{wheel.schedule(start + std::chrono::milliseconds{1}, {Timer_kind::T_REPLY, 1})};
+        wheel.expire(start + std::chrono::milliseconds{10}, expired);
+
+        wheel.schedule(start + std::chrono::milliseconds{20}, {Timer_kind::T_RETRANSMISSION, 2});
+        wheel.cancel(stale);
+
+        expired.clear();
+        wheel.expire(start + std::chrono::milliseconds{30}, expired);
+
+        return expired.size() == 1 && expired[0].kind == Timer_kind::T_RETRANSMISSION && expired[0].msg_id == 2;
+    }
+}
+
+int main()
+{
+    const bool is_expired_ok{report("cancel after expiration", testCancelAfterExpiration())};
+    const bool is_reused_ok{report("cancel of a reused node", testCancelOfReusedNode())};
+
+    return is_expired_ok && is_reused_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
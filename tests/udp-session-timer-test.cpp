@@ -0,0 +1,104 @@
+/**
+ * @file udp-session-timer-test.cpp
+ * @author Andrii Klymenko
+ * @brief Checks that a UDP session terminates when a REPLY timeout and a retransmission timeout expire together.
+ *
+ * The REPLY timeout sends an ERR and stops the retransmissions of the unconfirmed messages, including the one whose
+ * timer has expired in the same batch. The ERR has to be retransmitted until the session gives up and closes.
+ * Built and run by `make test`.
+ */
+
+#include "udp-session.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace
+{
+    using Clock = Protocol_session::Clock;
+
+    /// Max number of timer batches processed after the REPLY timeout before the session has to close.
+    constexpr int s_MAX_TIMER_BATCH_COUNT{10};
+
+    /**
+     * @brief Counts the actions of a type.
+     * @param actions Actions returned by the session.
+     * @param type The type.
+     */
+    std::size_t countActions(const Action_list& actions, Action_type type)
+    {
+        std::size_t count{0};
+
+        for(const Protocol_action& action : actions)
+        {
+            if(action.type == type)
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Builds a CONFIRM message.
+     * @param confirm Buffer of the message.
+     * @param msg_id MessageID of the confirmed message.
+     * @return The message.
+     */
+    std::string_view buildConfirm(char (&confirm)[Udp_session::s_BYTES_IN_MSG_HEADER], uint16_t msg_id)
+    {
+        confirm[0] = static_cast<char> (Protocol_msg_type::M_CONFIRM);
+        confirm[1] = static_cast<char> (msg_id >> 8);
+        confirm[2] = static_cast<char> (msg_id & 0xFF);
+        return {confirm, sizeof(confirm)};
+    }
+
+    /**
+     * @brief Leaves a MSG unconfirmed and starts waiting for the REPLY to JOIN, so that both timeouts expire in the
+     * same tick, then processes the timers until the session closes.
+     * @return True if the ERR has been sent and the session has closed.
+     */
+    bool testReplyAndRetransmissionTimeout()
+    {
+        Session_config config{};
+        config.udp_confirm_timeout = std::chrono::seconds{Protocol_session::s_MAX_REPLY_WAIT_TIME};
+        config.is_udp_confirm_timeout_fixed = true;
+        config.udp_window_size = 2;
+
+        Clock::time_point now{Clock::now()};
+        Udp_session session{config, now};
+        char confirm[Udp_session::s_BYTES_IN_MSG_HEADER]{};
+
+        // CONFIRM and REPLY to AUTH (MessageID 0)
+        session.processUserLine("/auth user secret name", now);
+        session.processDatagram(buildConfirm(confirm, 0), now);
+        session.processDatagram(std::string_view{"\x01\x00\x00\x01\x00\x00ok\x00", 9}, now);
+
+        // MSG (MessageID 1) stays unconfirmed, the CONFIRM of JOIN (MessageID 2) starts the REPLY timer
+        const bool is_msg_sent{countActions(session.processUserLine("hello", now), Action_type::A_SEND) == 1};
+        const bool is_join_sent{countActions(session.processUserLine("/join channel", now), Action_type::A_SEND) == 1};
+        session.processDatagram(buildConfirm(confirm, 2), now);
+
+        now += config.udp_confirm_timeout + std::chrono::milliseconds{1};
+        const Action_list& actions{session.processTimers(now)};
+        const bool is_err_sent{countActions(actions, Action_type::A_SEND) == 1
+            && countActions(actions, Action_type::A_PRINT_ERROR) == 1};
+
+        for(int i{0}; i < s_MAX_TIMER_BATCH_COUNT && !session.isClosed(); ++i)
+        {
+            now += config.udp_confirm_timeout + std::chrono::milliseconds{1};
+            session.processTimers(now);
+        }
+
+        return is_msg_sent && is_join_sent && is_err_sent && session.isClosed();
+    }
+}
+
+int main()
+{
+    const bool is_ok{testReplyAndRetransmissionTimeout()};
+    std::printf("REPLY and retransmission timeout in the same tick: %s\n", is_ok ? "OK" : "FAILED");
+
+    return is_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}